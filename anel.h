@@ -0,0 +1,122 @@
+#ifndef _ANEL_H_
+#define _ANEL_H_
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+///
+/// FILA CIRCULAR SEM TRAVAS (um produtor, um consumidor)
+///
+
+// Fila de capacidade fixa (potencia de 2), alocada na construcao, para ligar duas threads:
+// apenas uma thread insere (inserir/esperarInserir) e apenas uma thread retira
+// (retirar/esperarRetirar). As posicoes de insercao e de retirada ficam em linhas de
+// cache diferentes, para que o produtor e o consumidor nao disputem a mesma linha.
+//
+// As versoes que esperam tentam algumas vezes (ESPERA_GIROS) e depois bloqueiam em uma
+// variavel de condicao, de modo que uma thread parada (por exemplo, esperando uma entrada
+// lenta) nao ocupa o processador. Quem insere ou retira soh trava o mutex para acordar a
+// outra thread quando ela esta bloqueada; no caminho rapido a fila continua sem travas.
+template <class T>
+class AnelSPSC {
+private:
+  std::vector<T> elem;
+  size_t mascara;
+  // Proxima posicao a retirar (escrita apenas pelo consumidor)
+  alignas(64) std::atomic<size_t> cabeca;
+  // Proxima posicao a inserir (escrita apenas pelo produtor)
+  alignas(64) std::atomic<size_t> cauda;
+  // Threads bloqueadas em esperarInserir/esperarRetirar
+  alignas(64) std::atomic<unsigned> esperando;
+  std::mutex mtx;
+  std::condition_variable cond;
+
+  // Numero de tentativas (cedendo o processador) antes de bloquear
+  static const unsigned ESPERA_GIROS = 64;
+
+  bool tentarInserir(const T& X)
+  {
+    size_t c = cauda.load(std::memory_order_relaxed);
+    if (c-cabeca.load(std::memory_order_acquire) == elem.size()) return false;
+    elem[c & mascara] = X;
+    cauda.store(c+1, std::memory_order_release);
+    return true;
+  }
+
+  bool tentarRetirar(T& X)
+  {
+    size_t c = cabeca.load(std::memory_order_relaxed);
+    if (c == cauda.load(std::memory_order_acquire)) return false;
+    X = elem[c & mascara];
+    cabeca.store(c+1, std::memory_order_release);
+    return true;
+  }
+
+  // Acorda a outra thread, se estiver bloqueada (depois de uma insercao ou retirada)
+  // A barreira ordena a atualizacao da fila antes da leitura de esperando; do lado de quem
+  // bloqueia, o incremento de esperando vem antes de tentar de novo, sob o mutex
+  void acordar()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (esperando.load(std::memory_order_relaxed) == 0) return;
+    std::lock_guard<std::mutex> trava(mtx);
+    cond.notify_all();
+  }
+
+  // Chama Tentar ateh conseguir: primeiro girando, depois bloqueado
+  template <class Funcao>
+  void esperar(Funcao Tentar)
+  {
+    for (unsigned k=0; k<ESPERA_GIROS; k++)
+    {
+      if (Tentar()) {acordar(); return;}
+      std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> trava(mtx);
+      esperando.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!Tentar()) cond.wait(trava);
+      esperando.fetch_sub(1);
+    }
+    acordar();
+  }
+
+public:
+  // A capacidade eh arredondada para a proxima potencia de 2
+  explicit AnelSPSC(size_t Capacidade): cabeca(0), cauda(0), esperando(0)
+  {
+    size_t N = 1;
+    while (N<Capacidade) N *= 2;
+    elem.resize(N);
+    mascara = N-1;
+  }
+
+  size_t capacidade() const {return elem.size();}
+
+  // Insere X; retorna false se a fila estiver cheia
+  bool inserir(const T& X)
+  {
+    if (!tentarInserir(X)) return false;
+    acordar();
+    return true;
+  }
+
+  // Retira o proximo elemento para X; retorna false se a fila estiver vazia
+  bool retirar(T& X)
+  {
+    if (!tentarRetirar(X)) return false;
+    acordar();
+    return true;
+  }
+
+  // Versoes que esperam ateh haver espaco ou um elemento (ver acima)
+  void esperarInserir(const T& X) {esperar([&]() {return tentarInserir(X);});}
+  void esperarRetirar(T& X) {esperar([&]() {return tentarRetirar(X);});}
+};
+
+#endif // _ANEL_H_
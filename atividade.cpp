@@ -0,0 +1,233 @@
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include "atividade.h"
+#include "netlist.h"
+#include "rastro.h"
+
+// Numero de palavras (de 64 vetores) por lote e de lotes por rodada
+static const unsigned PALAVRAS_LOTE = 64;
+static const unsigned LOTES_RODADA = 256;
+static const unsigned long long AMOSTRAS_LOTE = 64ULL*PALAVRAS_LOTE;
+
+ParamAtividade::ParamAtividade():
+  maxAmostras(1ULL << 24), tolerancia(1e-3), semente(1), numThreads(0) {}
+
+// Leh as probabilidades das entradas de um arquivo
+bool ParamAtividade::lerProbabilidades(const std::string& arq, unsigned Nin)
+{
+  std::ifstream I(arq);
+  std::string lin;
+  if (!I.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  probT.clear();
+  probU.clear();
+  while (std::getline(I, lin))
+  {
+    lin = lin.substr(0, lin.find('#'));
+    std::istringstream L(lin);
+    double t, u = 0.0;
+    if (!(L >> t)) continue;
+    if (!(L >> u)) u = 0.0;
+    if (t<0.0 || u<0.0 || t+u>1.0)
+    {
+      std::cerr << "Probabilidades invalidas: " << lin << "\n\n";
+      return false;
+    }
+    probT.push_back(t);
+    probU.push_back(u);
+  }
+  if (probT.size()!=Nin)
+  {
+    std::cerr << "Arquivo com " << probT.size() << " entradas (esperado " << Nin << ")\n\n";
+    return false;
+  }
+  return true;
+}
+
+// Gerador pseudoaleatorio splitmix64 (estado S)
+static uint64_t proximoAleat(uint64_t& S)
+{
+  uint64_t X = (S += 0x9E3779B97F4A7C15ULL);
+  X = (X ^ (X >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  X = (X ^ (X >> 27)) * 0x94D049BB133111EBULL;
+  return X ^ (X >> 31);
+}
+
+// Palavra em que cada bit vale 1 com probabilidade Q/65536 (0 <= Q <= 65536)
+// A partir do bit menos significativo de Q: um bit 1 faz OU com uma palavra aleatoria
+// (probabilidade (1+p)/2), um bit 0 faz E (probabilidade p/2)
+static uint64_t palavraComVies(uint64_t& S, uint32_t Q)
+{
+  if (Q==0) return 0;
+  if (Q>=65536) return ~uint64_t(0);
+  uint64_t w = 0;
+  unsigned b = 0;
+  // Os bits 0 menos significativos nao mudam a palavra nula
+  while (((Q >> b) & 1)==0) b++;
+  for (; b<16; b++)
+  {
+    uint64_t r = proximoAleat(S);
+    w = ((Q >> b) & 1) ? (w | r) : (w & r);
+  }
+  return w;
+}
+
+// Probabilidade em ponto fixo (16 bits)
+static uint32_t pontoFixo(double P)
+{
+  return uint32_t(std::min(65536.0, std::max(0.0, std::floor(P*65536.0+0.5))));
+}
+
+bool estimarAtividade(const Circuit& C, const ParamAtividade& P, ResultadoAtividade& R)
+{
+  RASTRO_ESCOPO("estimar atividade");
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    std::cerr << "Circuito invalido para estimativa de atividade\n";
+    return false;
+  }
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nportas = N.getNumPorts();
+  if ((!P.probT.empty() && P.probT.size()!=Nin) || (!P.probU.empty() && P.probU.size()!=Nin))
+  {
+    std::cerr << "Numero de probabilidades diferente do numero de entradas\n";
+    return false;
+  }
+
+  // Vies de cada entrada: ? com probabilidade qU; entre as demais, T com probabilidade qT
+  std::vector<uint32_t> qU(Nin), qT(Nin);
+  for (unsigned i=0; i<Nin; i++)
+  {
+    double t = P.probT.empty() ? 0.5 : P.probT[i];
+    double u = P.probU.empty() ? 0.0 : P.probU[i];
+    if (t<0.0 || u<0.0 || t+u>1.0+1e-12)
+    {
+      std::cerr << "Probabilidades invalidas para a entrada " << -int(i)-1 << "\n";
+      return false;
+    }
+    qU[i] = pontoFixo(u);
+    qT[i] = (u<1.0) ? pontoFixo(t/(1.0-u)) : 0;
+  }
+
+  // Contadores globais, por porta
+  std::vector<unsigned long long> contT(Nportas, 0), contF(Nportas, 0), trocas(Nportas, 0);
+  std::mutex mtx;
+  unsigned long long totalLotes = std::max(1ULL, (P.maxAmostras+AMOSTRAS_LOTE-1)/AMOSTRAS_LOTE);
+  unsigned long long lotesFeitos = 0;
+  R.convergiu = false;
+
+  unsigned numThreads = P.numThreads;
+  if (numThreads==0) numThreads = std::thread::hardware_concurrency();
+  if (numThreads==0) numThreads = 1;
+
+  while (lotesFeitos<totalLotes && !R.convergiu)
+  {
+    const unsigned long long fimRodada = std::min(totalLotes, lotesFeitos+LOTES_RODADA);
+    std::atomic<unsigned long long> proximoLote(lotesFeitos);
+
+    auto trabalhador = [&]()
+    {
+      // Dois conjuntos de sinais, alternados: a palavra anterior fica no outro
+      std::vector<bool3S_64> S[2];
+      S[0].assign(N.getNumSinais(), bool3S_64{0,0});
+      S[1].assign(N.getNumSinais(), bool3S_64{0,0});
+      std::vector<unsigned long long> t(Nportas, 0), f(Nportas, 0), tr(Nportas, 0);
+      while (true)
+      {
+        unsigned long long lote = proximoLote++;
+        if (lote>=fimRodada) break;
+        uint64_t estado = P.semente ^ (lote * 0xD1B54A32D192ED03ULL);
+        estado = proximoAleat(estado);
+        for (unsigned w=0; w<PALAVRAS_LOTE; w++)
+        {
+          bool3S_64* atual = S[w&1].data();
+          const bool3S_64* ant = S[(w&1)^1].data();
+          for (unsigned i=0; i<Nin; i++)
+          {
+            uint64_t u = palavraComVies(estado, qU[i]);
+            uint64_t x = palavraComVies(estado, qT[i]);
+            atual[i] = bool3S_64{x & ~u, ~x & ~u};
+          }
+          N.simular(atual);
+          const bool3S_64* p = atual+Nin;
+          for (unsigned k=0; k<Nportas; k++)
+          {
+            t[k] += contarBits(p[k].t);
+            f[k] += contarBits(p[k].f);
+          }
+          // A primeira palavra do lote nao tem anterior
+          if (w>0)
+          {
+            const bool3S_64* q = ant+Nin;
+            for (unsigned k=0; k<Nportas; k++) tr[k] += contarBits((p[k].t ^ q[k].t) | (p[k].f ^ q[k].f));
+          }
+        }
+      }
+      std::lock_guard<std::mutex> L(mtx);
+      for (unsigned k=0; k<Nportas; k++)
+      {
+        contT[k] += t[k];
+        contF[k] += f[k];
+        trocas[k] += tr[k];
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned th=1; th<numThreads; th++) threads.emplace_back(trabalhador);
+    trabalhador();
+    for (std::thread& T : threads) T.join();
+    lotesFeitos = fimRodada;
+
+    // Erro padrao de cada estimativa
+    if (P.tolerancia>0.0)
+    {
+      double n = double(lotesFeitos*AMOSTRAS_LOTE);
+      double m = double(lotesFeitos*(PALAVRAS_LOTE-1)*64);
+      double maior = 0.0;
+      for (unsigned k=0; k<Nportas; k++)
+      {
+        double pt = contT[k]/n, pf = contF[k]/n, r = trocas[k]/m;
+        maior = std::max(maior, std::max(pt*(1.0-pt), pf*(1.0-pf))/n);
+        maior = std::max(maior, r*(1.0-r)/m);
+      }
+      R.convergiu = std::sqrt(maior) < P.tolerancia;
+    }
+  }
+
+  R.numAmostras = lotesFeitos*AMOSTRAS_LOTE;
+  const double n = double(R.numAmostras);
+  const double m = double(lotesFeitos*(PALAVRAS_LOTE-1)*64);
+  R.probT.resize(Nportas);
+  R.probF.resize(Nportas);
+  R.probU.resize(Nportas);
+  R.taxaTroca.resize(Nportas);
+  for (unsigned k=0; k<Nportas; k++)
+  {
+    R.probT[k] = contT[k]/n;
+    R.probF[k] = contF[k]/n;
+    R.probU[k] = (R.numAmostras-contT[k]-contF[k])/n;
+    R.taxaTroca[k] = trocas[k]/m;
+  }
+  return true;
+}
+
+// Imprime uma linha por porta
+std::ostream& operator<<(std::ostream& O, const ResultadoAtividade& R)
+{
+  O << R.numAmostras << " amostra(s)" << (R.convergiu ? " (tolerancia atingida)" : "") << '\n';
+  O << "PORTA" << '\t' << "P(T)" << '\t' << "P(F)" << '\t' << "P(?)" << '\t' << "TROCA" << '\n';
+  for (unsigned k=0; k<R.probT.size(); k++)
+  {
+    O << k+1 << '\t' << R.probT[k] << '\t' << R.probF[k] << '\t' << R.probU[k] << '\t' << R.taxaTroca[k] << '\n';
+  }
+  return O;
+}
@@ -0,0 +1,66 @@
+#ifndef _ATIVIDADE_H_
+#define _ATIVIDADE_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "circuit.h"
+
+///
+/// ESTIMATIVA DE PROBABILIDADES E DE ATIVIDADE (Monte Carlo bit-paralelo)
+///
+
+// Estima, para cada porta do circuito, a probabilidade de a saida valer T, F e ? e a
+// taxa de troca (fracao das transicoes entre vetores consecutivos em que a saida muda),
+// com vetores aleatorios independentes em que cada entrada vale ? com probabilidade
+// probU[i], T com probabilidade probT[i] e F no restante.
+//
+// Os vetores sao simulados 64 por vez (Netlist, bool3S_64): cada pista eh uma sequencia
+// de vetores no tempo, e as contagens sao feitas com contagem de bits (contarBits) das
+// palavras de cada porta. As palavras de entrada com vies sao montadas bit a bit a partir
+// da expansao binaria da probabilidade (16 bits de precisao).
+//
+// O trabalho eh dividido em lotes de palavras, cada um com a sua propria sequencia
+// pseudoaleatoria (que depende apenas da semente e do indice do lote), simulados em
+// rodadas por NumThreads threads. Ao final de cada rodada, a simulacao para se o erro
+// padrao de todas as probabilidades e taxas estimadas for menor que a tolerancia, ou se
+// jah foram simuladas maxAmostras amostras. O resultado nao depende do numero de threads.
+// Os flip-flops, se houver, ficam com estado UNDEF.
+
+struct ParamAtividade {
+  // Probabilidades de cada entrada valer T e ? (vazios: 0.5 e 0 para todas)
+  std::vector<double> probT;
+  std::vector<double> probU;
+  // Numero maximo de amostras (vetores), arredondado para cima para lotes de 4096
+  unsigned long long maxAmostras;
+  // Erro padrao maximo das estimativas para parar antes de maxAmostras (0: nunca para antes)
+  double tolerancia;
+  uint64_t semente;
+  // Numero de threads (0: uma por nucleo)
+  unsigned numThreads;
+
+  ParamAtividade();
+  // Leh as probabilidades das entradas de um arquivo com uma linha "probT [probU]" por
+  // entrada, na ordem -1, -2, ...; linhas vazias e comentarios (#) sao ignorados
+  // Retorna false (com uma mensagem em cerr) se deu erro
+  bool lerProbabilidades(const std::string& arq, unsigned Nin);
+};
+
+struct ResultadoAtividade {
+  unsigned long long numAmostras;
+  // A simulacao parou porque as estimativas atingiram a tolerancia
+  bool convergiu;
+  // Probabilidades e taxa de troca da porta P (de 0 a Nportas-1)
+  std::vector<double> probT, probF, probU;
+  std::vector<double> taxaTroca;
+};
+
+// Estima as probabilidades e a atividade de todas as portas do circuito C
+// Retorna false (com uma mensagem em cerr) se o circuito ou os parametros forem invalidos
+bool estimarAtividade(const Circuit& C, const ParamAtividade& P, ResultadoAtividade& R);
+
+// Imprime uma linha por porta: id, probabilidades de T, F e ? e taxa de troca
+std::ostream& operator<<(std::ostream& O, const ResultadoAtividade& R);
+
+#endif // _ATIVIDADE_H_
@@ -0,0 +1,86 @@
+#ifndef _BOOL3S_64_H_
+#define _BOOL3S_64_H_
+
+#include <cstdint>
+#include "bool3S.h"
+
+///
+/// 64 VALORES bool3S EMPACOTADOS (simulacao bit-paralela)
+///
+
+// Cada um dos 64 bits ("pistas") representa um valor bool3S independente,
+// com codificacao em dois trilhos:
+// - bit i de t == 1: a pista i vale TRUE
+// - bit i de f == 1: a pista i vale FALSE
+// - nenhum dos dois: a pista i vale UNDEF
+// (t e f nunca tem o mesmo bit ligado)
+// Os operadores seguem exatamente a logica de 3 estados de bool3S, pista a pista,
+// de modo que uma operacao sobre bool3S_64 equivale a 64 operacoes sobre bool3S.
+struct bool3S_64 {
+  uint64_t t;
+  uint64_t f;
+};
+
+// Todas as pistas com o mesmo valor
+inline bool3S_64 difundir(bool3S x)
+{
+  if (x==bool3S::TRUE) return {~uint64_t(0), 0};
+  if (x==bool3S::FALSE) return {0, ~uint64_t(0)};
+  return {0, 0};
+}
+
+// Valor da pista I (de 0 a 63)
+inline bool3S lerPista(const bool3S_64& X, unsigned I)
+{
+  if ((X.t >> I) & 1) return bool3S::TRUE;
+  if ((X.f >> I) & 1) return bool3S::FALSE;
+  return bool3S::UNDEF;
+}
+
+// Fixa o valor da pista I (de 0 a 63)
+inline void fixarPista(bool3S_64& X, unsigned I, bool3S x)
+{
+  uint64_t m = uint64_t(1) << I;
+  X.t &= ~m;
+  X.f &= ~m;
+  if (x==bool3S::TRUE) X.t |= m;
+  else if (x==bool3S::FALSE) X.f |= m;
+}
+
+// Pistas definidas (TRUE ou FALSE)
+inline uint64_t definidas(const bool3S_64& X) {return X.t | X.f;}
+
+inline bool operator==(const bool3S_64& X1, const bool3S_64& X2) {return X1.t==X2.t && X1.f==X2.f;}
+inline bool operator!=(const bool3S_64& X1, const bool3S_64& X2) {return !(X1==X2);}
+
+// NOT 3S
+inline bool3S_64 operator~(const bool3S_64& X) {return {X.f, X.t};}
+// AND 3S: TRUE se as duas TRUE; FALSE se alguma FALSE
+inline bool3S_64 operator&(const bool3S_64& X1, const bool3S_64& X2) {return {X1.t & X2.t, X1.f | X2.f};}
+// OR 3S: TRUE se alguma TRUE; FALSE se as duas FALSE
+inline bool3S_64 operator|(const bool3S_64& X1, const bool3S_64& X2) {return {X1.t | X2.t, X1.f & X2.f};}
+// XOR 3S: UNDEF se alguma UNDEF
+inline bool3S_64 operator^(const bool3S_64& X1, const bool3S_64& X2)
+{
+  uint64_t def = definidas(X1) & definidas(X2);
+  uint64_t p = X1.t ^ X2.t;
+  return {p & def, ~p & def};
+}
+
+inline void operator&=(bool3S_64& X1, const bool3S_64& X2) {X1 = X1 & X2;}
+inline void operator|=(bool3S_64& X1, const bool3S_64& X2) {X1 = X1 | X2;}
+inline void operator^=(bool3S_64& X1, const bool3S_64& X2) {X1 = X1 ^ X2;}
+
+// Numero de bits 1 de uma palavra
+inline unsigned contarBits(uint64_t x)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll(x);
+#else
+  unsigned n = 0;
+  for (; x; x &= x-1) n++;
+  return n;
+#endif
+}
+
+#endif // _BOOL3S_64_H_
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include "bytecode.h"
+#include "rastro.h"
+
+// Despacho com goto computado (extensao do GCC/Clang), ou com switch
+#if defined(__GNUC__) && !defined(CIRCUITO_SEM_GOTO)
+#define BYTECODE_GOTO
+#endif
+
+// Operacoes do programa, na ordem dos codigos
+// (NOP: flip-flop, que mantem o seu valor; COPIA: porta de uma entrada sem inversao)
+#define OPERACOES_BYTECODE(X) \
+  X(FIM) X(NOP) X(COPIA) X(NOT) \
+  X(AND2) X(NAND2) X(OR2) X(NOR2) X(XOR2) X(NXOR2) \
+  X(ANDN) X(NANDN) X(ORN) X(NORN) X(XORN) X(NXORN) \
+  X(AND2_NOT) X(NAND2_NOT) X(OR2_NOT) X(NOR2_NOT) X(XOR2_NOT) X(NXOR2_NOT) \
+  X(AND2_AND2) X(NAND2_NAND2) X(OR2_OR2) X(NOR2_NOR2) X(XOR2_XOR2) X(NXOR2_NXOR2)
+
+enum OperacaoBytecode : uint32_t {
+#define ENUMERAR_OPERACAO(Nome) OP_##Nome,
+  OPERACOES_BYTECODE(ENUMERAR_OPERACAO)
+#undef ENUMERAR_OPERACAO
+  NUM_OPERACOES
+};
+
+// O codigo da operacao ocupa os 8 bits baixos; as operacoes de n entradas guardam n
+// nos bits seguintes
+static const uint32_t MASCARA_OPERACAO = 0xFF;
+static const unsigned BITS_OPERACAO = 8;
+
+// Deslocamento entre a operacao de 2 entradas de um tipo e as suas versoes de n entradas,
+// com NOT e encadeada
+static const uint32_t DESLOC_N = OP_ANDN-OP_AND2;
+static const uint32_t DESLOC_NOT = OP_AND2_NOT-OP_AND2;
+static const uint32_t DESLOC_DUPLA = OP_AND2_AND2-OP_AND2;
+
+// Operacao de 2 entradas de cada tipo de porta (FIM se nao houver)
+static uint32_t operacao2(TipoPorta T)
+{
+  switch (T)
+  {
+  case TipoPorta::AN: return OP_AND2;
+  case TipoPorta::NA: return OP_NAND2;
+  case TipoPorta::OR: return OP_OR2;
+  case TipoPorta::NO: return OP_NOR2;
+  case TipoPorta::XO: return OP_XOR2;
+  case TipoPorta::NX: return OP_NXOR2;
+  default: return OP_FIM;
+  }
+}
+
+///
+/// CLASSE PROGRAMABYTECODE
+///
+
+ProgramaBytecode::ProgramaBytecode():
+  Nin(0), numSinais(0), inicioLaco(0), sinalLaco(0), numInstrucoes(0), numFundidas(0) {}
+
+// Esvazia o programa
+void ProgramaBytecode::clear()
+{
+  Nin = 0;
+  numSinais = 0;
+  codigo.clear();
+  inicioLaco = 0;
+  sinalLaco = 0;
+  indice.clear();
+  saidas.clear();
+  numInstrucoes = 0;
+  numFundidas = 0;
+}
+
+// Compila o circuito C
+bool ProgramaBytecode::compilar(const Circuit& C)
+{
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    clear();
+    return false;
+  }
+  return compilar(N);
+}
+
+// Compila a netlist N
+bool ProgramaBytecode::compilar(const Netlist& N)
+{
+  RASTRO_ESCOPO("compilar bytecode");
+  clear();
+  if (N.getNumPorts()==0) return false;
+  Nin = N.getNumInputs();
+  numSinais = N.getNumSinais();
+  const unsigned NP = N.getNumPorts();
+  const std::vector<unsigned>& ordem = N.getOrdem();
+  const unsigned laco = N.getInicioLaco();
+
+  // Ordem das portas sem lacos: algoritmo de Kahn com uma pilha, de modo que uma porta
+  // que fica pronta eh avaliada logo em seguida
+  std::vector<unsigned> falta(NP, 0);
+  std::vector<bool> semLaco(NP, false);
+  for (unsigned i=0; i<laco; i++) semLaco[ordem[i]] = true;
+  for (unsigned i=0; i<laco; i++)
+  {
+    unsigned P = ordem[i];
+    if (N.getTipo(P)==TipoPorta::FF) continue;
+    const unsigned* e = N.getEntradas(P);
+    for (unsigned k=0; k<N.getNumInputsPort(P); k++) if (e[k]>=Nin) falta[P]++;
+  }
+  std::vector<unsigned> seq, pilha;
+  seq.reserve(NP);
+  for (unsigned i=laco; i-- > 0; ) if (falta[ordem[i]]==0) pilha.push_back(ordem[i]);
+  while (!pilha.empty())
+  {
+    unsigned P = pilha.back();
+    pilha.pop_back();
+    seq.push_back(P);
+    const unsigned* f = N.getFanout(Nin+P);
+    for (unsigned k=0; k<N.getNumFanout(Nin+P); k++)
+    {
+      if (semLaco[f[k]] && --falta[f[k]]==0) pilha.push_back(f[k]);
+    }
+  }
+  // As portas em lacos, na ordem da netlist
+  seq.insert(seq.end(), ordem.begin()+laco, ordem.end());
+
+  // Renumeracao dos sinais: as entradas e depois as portas, na ordem de avaliacao
+  indice.resize(numSinais);
+  for (unsigned i=0; i<Nin; i++) indice[i] = i;
+  for (unsigned k=0; k<NP; k++) indice[Nin+seq[k]] = Nin+k;
+  for (unsigned j=0; j<N.getNumOutputs(); j++) saidas.push_back(indice[N.getSaida(j)]);
+  sinalLaco = Nin+laco;
+
+  // Geracao das instrucoes de seq[K0] ateh seq[K1-1], terminadas por FIM
+  auto gerar = [&](unsigned K0, unsigned K1)
+  {
+    for (unsigned k=K0; k<K1; k++)
+    {
+      unsigned P = seq[k];
+      TipoPorta t = N.getTipo(P);
+      const unsigned* e = N.getEntradas(P);
+      const unsigned n = N.getNumInputsPort(P);
+      uint32_t op2 = operacao2(t);
+      numInstrucoes++;
+      if (t==TipoPorta::FF)
+      {
+        codigo.push_back(OP_NOP);
+        continue;
+      }
+      if (t==TipoPorta::NT || n==1)
+      {
+        bool inverte = (t==TipoPorta::NT || t==TipoPorta::NA || t==TipoPorta::NO || t==TipoPorta::NX);
+        codigo.push_back(inverte ? OP_NOT : OP_COPIA);
+        codigo.push_back(indice[e[0]]);
+        continue;
+      }
+      if (n>2)
+      {
+        codigo.push_back((op2+DESLOC_N) | (n << BITS_OPERACAO));
+        for (unsigned j=0; j<n; j++) codigo.push_back(indice[e[j]]);
+        continue;
+      }
+      // Porta de 2 entradas: tenta fundir com a seguinte
+      if (k+1<K1)
+      {
+        unsigned Q = seq[k+1];
+        const unsigned* eq = N.getEntradas(Q);
+        const unsigned nq = N.getNumInputsPort(Q);
+        if (N.getTipo(Q)==TipoPorta::NT && eq[0]==Nin+P)
+        {
+          codigo.push_back(op2+DESLOC_NOT);
+          codigo.push_back(indice[e[0]]);
+          codigo.push_back(indice[e[1]]);
+          numFundidas++;
+          k++;
+          continue;
+        }
+        if (N.getTipo(Q)==t && nq==2 && (eq[0]==Nin+P) != (eq[1]==Nin+P))
+        {
+          codigo.push_back(op2+DESLOC_DUPLA);
+          codigo.push_back(indice[e[0]]);
+          codigo.push_back(indice[e[1]]);
+          codigo.push_back(indice[eq[0]==Nin+P ? eq[1] : eq[0]]);
+          numFundidas++;
+          k++;
+          continue;
+        }
+      }
+      codigo.push_back(op2);
+      codigo.push_back(indice[e[0]]);
+      codigo.push_back(indice[e[1]]);
+    }
+    codigo.push_back(OP_FIM);
+  };
+  gerar(0, laco);
+  inicioLaco = codigo.size();
+  gerar(laco, NP);
+  return true;
+}
+
+// Executa uma parte do programa
+template <bool LACO>
+bool ProgramaBytecode::executar(const uint32_t* Pc, bool3S_64* Sinais, unsigned D) const
+{
+  bool3S_64* v = Sinais;
+  bool mudou = false;
+  bool3S_64 x;
+
+// Escreve o proximo sinal (e, nos lacos, verifica se mudou)
+#define ESCREVER(Valor) \
+  do { \
+    const bool3S_64 valor_ = (Valor); \
+    if (LACO && valor_!=v[D]) mudou = true; \
+    v[D++] = valor_; \
+  } while (0)
+
+#ifdef BYTECODE_GOTO
+  static const void* const ROTULOS[NUM_OPERACOES] = {
+#define ROTULO_OPERACAO(Nome) &&L_##Nome,
+    OPERACOES_BYTECODE(ROTULO_OPERACAO)
+#undef ROTULO_OPERACAO
+  };
+#define INSTRUCAO(Nome) L_##Nome:
+#define PROXIMA goto *ROTULOS[*Pc & MASCARA_OPERACAO]
+  PROXIMA;
+#else
+#define INSTRUCAO(Nome) case OP_##Nome:
+#define PROXIMA continue
+  for (;;) switch (*Pc & MASCARA_OPERACAO) {
+#endif
+
+// Porta de 2 entradas, porta de n entradas, seguida de NOT e seguida de outra igual
+#define INSTRUCOES_TIPO(Nome, Op, Inv) \
+  INSTRUCAO(Nome##2) \
+    ESCREVER(Inv(v[Pc[1]] Op v[Pc[2]])); \
+    Pc += 3; \
+    PROXIMA; \
+  INSTRUCAO(Nome##N) \
+    { \
+      const uint32_t n = *Pc >> BITS_OPERACAO; \
+      x = v[Pc[1]]; \
+      for (uint32_t j=2; j<=n; j++) x = x Op v[Pc[j]]; \
+      ESCREVER(Inv(x)); \
+      Pc += n+1; \
+    } \
+    PROXIMA; \
+  INSTRUCAO(Nome##2_NOT) \
+    x = Inv(v[Pc[1]] Op v[Pc[2]]); \
+    ESCREVER(x); \
+    ESCREVER(~x); \
+    Pc += 3; \
+    PROXIMA; \
+  INSTRUCAO(Nome##2_##Nome##2) \
+    x = Inv(v[Pc[1]] Op v[Pc[2]]); \
+    ESCREVER(x); \
+    ESCREVER(Inv(x Op v[Pc[3]])); \
+    Pc += 4; \
+    PROXIMA;
+
+  INSTRUCAO(FIM)
+    return mudou;
+  INSTRUCAO(NOP)
+    D++;
+    Pc++;
+    PROXIMA;
+  INSTRUCAO(COPIA)
+    ESCREVER(v[Pc[1]]);
+    Pc += 2;
+    PROXIMA;
+  INSTRUCAO(NOT)
+    ESCREVER(~v[Pc[1]]);
+    Pc += 2;
+    PROXIMA;
+  INSTRUCOES_TIPO(AND, &, )
+  INSTRUCOES_TIPO(NAND, &, ~)
+  INSTRUCOES_TIPO(OR, |, )
+  INSTRUCOES_TIPO(NOR, |, ~)
+  INSTRUCOES_TIPO(XOR, ^, )
+  INSTRUCOES_TIPO(NXOR, ^, ~)
+
+#ifndef BYTECODE_GOTO
+  }
+#endif
+#undef INSTRUCOES_TIPO
+#undef INSTRUCAO
+#undef PROXIMA
+#undef ESCREVER
+}
+
+// Simula o circuito para 64 vetores de entrada ao mesmo tempo
+void ProgramaBytecode::simular(bool3S_64* Sinais) const
+{
+  if (codigo.empty()) return;
+  executar<false>(codigo.data(), Sinais, Nin);
+  if (sinalLaco==numSinais) return;
+  // Parte com lacos: parte de UNDEF e reavalia ateh o ponto fixo
+  std::fill(Sinais+sinalLaco, Sinais+numSinais, bool3S_64{0,0});
+  while (executar<true>(codigo.data()+inicioLaco, Sinais, sinalLaco));
+}
+
+// Simula o circuito para um unico vetor de entradas (com os flip-flops em UNDEF)
+bool ProgramaBytecode::simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const
+{
+  if (in_circ.size()!=Nin || codigo.empty()) return false;
+  std::vector<bool3S_64> S(numSinais, bool3S_64{0,0});
+  for (unsigned i=0; i<Nin; i++) S[i] = difundir(in_circ[i]);
+  simular(S.data());
+  out_circ.resize(saidas.size());
+  for (unsigned j=0; j<saidas.size(); j++) out_circ[j] = lerPista(S[saidas[j]], 0);
+  return true;
+}
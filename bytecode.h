@@ -0,0 +1,91 @@
+#ifndef _BYTECODE_H_
+#define _BYTECODE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SIMULACAO COM BYTECODE (interpretador portavel com superinstrucoes)
+///
+
+// Traduz a netlist levelizada para um programa compacto de palavras de 32 bits, executado
+// por um laco de despacho encadeado (goto computado no GCC/Clang; switch nos demais
+// compiladores, ou com a macro CIRCUITO_SEM_GOTO). Cada instrucao eh o codigo da operacao
+// seguido dos indices das suas entradas; a saida nao eh codificada, porque os sinais sao
+// renumerados na ordem de execucao: a instrucao que avalia a k-esima porta escreve no
+// sinal Nin+k. As operacoes sao:
+// - NOT, copia (porta de uma entrada) e AND2, NAND2, OR2, NOR2, XOR2, NXOR2;
+// - AND, NAND, OR, NOR, XOR e NXOR de n entradas (n no proprio codigo da operacao);
+// - superinstrucoes, que avaliam duas portas seguidas: uma porta de 2 entradas seguida
+//   do NOT da sua saida (AND2->NOT etc.), ou seguida de outra porta do mesmo tipo que
+//   usa a sua saida (AND2->AND2 etc.).
+// As portas sem lacos sao ordenadas em profundidade (cada porta logo depois da ultima
+// porta que a alimenta, quando possivel), o que cria pares para as superinstrucoes e
+// aproxima na memoria os sinais usados juntos. As portas em lacos ficam no fim e sao
+// reavaliadas ateh que nenhuma mude, partindo de UNDEF, como em Netlist::simular.
+// Os flip-flops mantem o valor fixado antes da simulacao (o seu estado).
+
+class ProgramaBytecode {
+private:
+  unsigned Nin;
+  unsigned numSinais;
+  // Programa: parte sem lacos, a partir de 0, e parte com lacos, a partir de inicioLaco
+  std::vector<uint32_t> codigo;
+  size_t inicioLaco;
+  // Os sinais a partir de sinalLaco sao das portas em lacos
+  unsigned sinalLaco;
+  // Indice no vetor de sinais do programa de cada sinal da netlist
+  std::vector<unsigned> indice;
+  // Sinal de origem de cada saida do circuito (numeracao do programa)
+  std::vector<unsigned> saidas;
+  // Numero de instrucoes e de superinstrucoes
+  unsigned numInstrucoes;
+  unsigned numFundidas;
+
+  // Executa uma parte do programa a partir de Pc, escrevendo a partir do sinal D
+  // Com LACO, retorna true se algum sinal mudou
+  template <bool LACO>
+  bool executar(const uint32_t* Pc, bool3S_64* Sinais, unsigned D) const;
+
+public:
+  ProgramaBytecode();
+
+  // Compila o circuito C (ou a netlist N jah compilada)
+  // Retorna false (e deixa o programa vazio) se o circuito nao for valido
+  bool compilar(const Circuit& C);
+  bool compilar(const Netlist& N);
+
+  // Esvazia o programa
+  void clear();
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumOutputs() const {return saidas.size();}
+  unsigned getNumSinais() const {return numSinais;}
+  // Indice, no vetor de sinais do programa, do sinal S da netlist (as entradas do
+  // circuito mantem os indices 0 a Nin-1)
+  unsigned getSinal(unsigned S) const {return indice[S];}
+  // Sinal de origem da saida J do circuito (de 0 a Nout-1), na numeracao do programa
+  unsigned getSaida(unsigned J) const {return saidas[J];}
+
+  // Tamanho do programa, em bytes
+  size_t getTamanhoCodigo() const {return codigo.size()*sizeof(uint32_t);}
+  unsigned getNumInstrucoes() const {return numInstrucoes;}
+  // Numero de superinstrucoes (cada uma avalia duas portas)
+  unsigned getNumFundidas() const {return numFundidas;}
+
+  // Simula o circuito para 64 vetores de entrada ao mesmo tempo
+  // Sinais deve ter getNumSinais() elementos (na numeracao do programa), com as entradas
+  // (0 a Nin-1) e os estados dos flip-flops (getSinal) jah fixados
+  void simular(bool3S_64* Sinais) const;
+
+  // Simula o circuito para um unico vetor de entradas (com os flip-flops em UNDEF)
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const;
+};
+
+#endif // _BYTECODE_H_
@@ -1,116 +1,569 @@
-#include <iostream>
-#include <string>
-#include "circuit.h"
-
-using namespace std;
-
-void gerarTabela(Circuit& C);
-
-int main(void)
-{
-  Circuit C;
-  string nome;
-  int opcao;
-
-  do {
-    cout << "\nPROGRAMA SIMULADOR DE CIRCUITOS DIGITAIS:\n";
-    do {
-      cout << "0 - Sair\n";
-      cout << "1 - Digitar um circuito via teclado\n";
-      cout << "2 - Salvar um circuito em arquivo\n";
-      cout << "3 - Ler um circuito de arquivo\n";
-      cout << "4 - Imprimir o circuito na tela\n";
-      cout << "5 - Simular o circuito para todas as entrada (gerar tabela verdade)\n";
-      cout << "Qual sua opcao? ";
-      cin >> opcao;
-    } while(opcao<0 || opcao>5);
-    switch(opcao){
-    case 1:
-      C.digitar();
-      break;
-    case 2:
-    case 3:
-      // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
-      cin.ignore(256,'\n');
-      do {
-        cout << "Arquivo: ";
-        getline(cin,nome);
-      } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
-      if (opcao==3) {
-        if (!C.ler(nome))
-        {
-          // Erro na leitura
-          cerr << "Arquivo " << nome << " invalido para leitura\n";
-        }
-      }
-      else {
-        if (!C.salvar(nome))
-        {
-          // Erro no salvamento
-          cerr << "Arquivo " << nome << " invalido para escrita\n";
-        }
-      }
-      break;
-    case 4:
-      C.imprimir();
-      break;
-    case 5:
-      gerarTabela(C);
-      break;
-    default:
-      break;
-    }
-  } while(opcao != 0);
-}
-
-void gerarTabela(Circuit& C)
-{
-  vector<bool3S> in_circ(C.getNumInputs());
-  int i;
-
-  // Comeca com todas as entradas indefinidas
-  for (i=0; i<(int)C.getNumInputs(); i++)
-  {
-    in_circ.at(i) = bool3S::UNDEF;
-  }
-
-  cout << "ENTRADAS" << '\t' << "SAIDAS" << endl;
-  do
-  {
-    // Simulacao
-    C.simular(in_circ);
-
-    // Impressao das entradas
-    for (i=0; i<(int)C.getNumInputs(); i++)
-    {
-      cout << in_circ.at(i);
-      if (i<(int)C.getNumInputs()-1) cout << ' ';
-      else
-      {
-        cout <<'\t';
-        if (C.getNumInputs()<=2) cout <<'\t';
-      }
-    }
-
-    // Impressao das saidas
-    for (i=0; i<(int)C.getNumOutputs(); i++)
-    {
-      cout << C.getOutput(i+1);
-      if (i<(int)C.getNumOutputs()-1) cout << ' ';
-      else cout << '\n';
-    }
-
-    // Determina qual entrada deve ser incrementada na proxima linha
-    // Incrementa a ultima possivel que nao for TRUE
-    // Se a ultima for TRUE, faz essa ser UNDEF e tenta incrementar a anterior
-    i = int(C.getNumInputs())-1;
-    while (i>=0 && in_circ.at(i)==bool3S::TRUE)
-    {
-      in_circ.at(i)++;
-      i--;
-    };
-    // Incrementa a input selecionada
-    if (i>=0) in_circ.at(i)++;
-  } while (i>=0);
-}
-
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include "circuit.h"
+#include "gerador.h"
+#include "tabela.h"
+#include "importar.h"
+#include "estimulo.h"
+#include "simconcorrente.h"
+#include "simatraso.h"
+#include "simciclo.h"
+#include "hierarquia.h"
+#include "equivalencia.h"
+#include "servidor.h"
+#include "atividade.h"
+#include "justificacao.h"
+#include "mapeamento.h"
+#include "codigocpp.h"
+#include "reordenacao.h"
+#include "linhacomando.h"
+#include "rastro.h"
+
+using namespace std;
+
+void gerarSintetico();
+void simularFalhas(const Circuit& C);
+void simularAtrasos(const Circuit& C);
+void simularCiclos(const Circuit& C);
+void verificarEquivalencia(const Circuit& C);
+void executarServidor(const Circuit& C);
+void estimarAtividade(const Circuit& C);
+void gerarTabelaRestrita(const Circuit& C);
+void justificarSaidas(const Circuit& C);
+void tabularCircuito(Circuit& C);
+void mapearLUTs(const Circuit& C);
+void gerarCodigo(const Circuit& C);
+void reordenarCircuito(Circuit& C);
+void simularHierarquico();
+
+int main(int argc, char* argv[])
+{
+  Circuit C;
+  string nome;
+  int opcao;
+
+  // Com argumentos, executa um subcomando sem o menu interativo
+  if (argc > 1) return executarLinhaComando(argc, argv);
+
+  do {
+    cout << "\nPROGRAMA SIMULADOR DE CIRCUITOS DIGITAIS:\n";
+    do {
+      cout << "0 - Sair\n";
+      cout << "1 - Digitar um circuito via teclado\n";
+      cout << "2 - Salvar um circuito em arquivo\n";
+      cout << "3 - Ler um circuito de arquivo\n";
+      cout << "4 - Imprimir o circuito na tela\n";
+      cout << "5 - Simular o circuito para todas as entrada (gerar tabela verdade)\n";
+      cout << "6 - Gerar um circuito sintetico em arquivo\n";
+      cout << "7 - Importar um circuito de arquivo .bench ou .blif\n";
+      cout << "8 - Imprimir as estatisticas de simulacao\n";
+      cout << "9 - Simular falhas stuck-at para um arquivo de estimulos\n";
+      cout << "10 - Simular com atrasos um arquivo de estimulos\n";
+      cout << "11 - Simular ciclos de clock (circuito sequencial) um arquivo de estimulos\n";
+      cout << "12 - Ler um circuito hierarquico (com subcircuitos) e achatar\n";
+      cout << "13 - Verificar a equivalencia com um circuito de arquivo\n";
+      cout << "14 - Executar o servidor de simulacao (socket local)\n";
+      cout << "15 - Resumir a tabela verdade (contagens, saidas constantes e dependencias)\n";
+      cout << "16 - Estimar as probabilidades e a atividade das portas (Monte Carlo)\n";
+      cout << "17 - Simular o circuito para as entradas F e T (tabela verdade com 2 valores)\n";
+      cout << "18 - Simular o circuito com entradas restritas (tabela verdade parcial)\n";
+      cout << "19 - Justificar saidas (procurar entradas que dao os valores pedidos)\n";
+      cout << "20 - Ligar ou desligar a tabela de consulta (simulacao rapida de circuitos pequenos)\n";
+      cout << "21 - Mapear o circuito em LUTs (tabelas de ateh 6 entradas)\n";
+      cout << "22 - Gerar um cabecalho C++ que avalia o circuito (codigo em linha reta)\n";
+      cout << "23 - Reordenar as portas do circuito (localidade de memoria)\n";
+      cout << "24 - Simular um circuito hierarquico (sem achatar) um arquivo de estimulos\n";
+      cout << "Qual sua opcao? ";
+      cin >> opcao;
+    } while(opcao<0 || opcao>24);
+    switch(opcao){
+    case 1:
+      C.digitar();
+      break;
+    case 2:
+    case 3:
+    case 7:
+    case 12:
+      // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+      cin.ignore(256,'\n');
+      do {
+        cout << "Arquivo: ";
+        getline(cin,nome);
+      } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+      if (opcao==3) {
+        if (!C.ler(nome))
+        {
+          // Erro na leitura
+          cerr << "Arquivo " << nome << " invalido para leitura\n";
+        }
+      }
+      else if (opcao==7) {
+        if (!importarCircuito(nome,C))
+        {
+          // Erro na importacao
+          cerr << "Arquivo " << nome << " invalido para importacao\n";
+        }
+      }
+      else if (opcao==12) {
+        CircuitoHierarquico H;
+        if (!H.ler(nome) || !H.achatar(C))
+        {
+          // Erro na leitura ou no achatamento
+          cerr << "Arquivo " << nome << " invalido para leitura\n";
+        }
+        else
+        {
+          cout << H.getNumDefinicoes() << " subcircuito(s), " << H.getNumElementos()
+               << " elemento(s) armazenado(s), " << C.getNumPorts() << " porta(s) no circuito achatado\n";
+        }
+      }
+      else {
+        if (!C.salvar(nome))
+        {
+          // Erro no salvamento
+          cerr << "Arquivo " << nome << " invalido para escrita\n";
+        }
+      }
+      break;
+    case 4:
+      C.imprimir();
+      break;
+    case 5:
+      gerarTabela(C);
+      break;
+    case 6:
+      gerarSintetico();
+      break;
+    case 8:
+      C.imprimirEstatisticas();
+      break;
+    case 9:
+      simularFalhas(C);
+      break;
+    case 10:
+      simularAtrasos(C);
+      break;
+    case 11:
+      simularCiclos(C);
+      break;
+    case 13:
+      verificarEquivalencia(C);
+      break;
+    case 14:
+      executarServidor(C);
+      break;
+    case 15:
+      {
+        ResumoTabela R;
+        if (resumirTabela(C, R)) cout << R;
+      }
+      break;
+    case 16:
+      estimarAtividade(C);
+      break;
+    case 17:
+      gerarTabelaBinaria(C);
+      break;
+    case 18:
+      gerarTabelaRestrita(C);
+      break;
+    case 19:
+      justificarSaidas(C);
+      break;
+    case 20:
+      tabularCircuito(C);
+      break;
+    case 21:
+      mapearLUTs(C);
+      break;
+    case 22:
+      gerarCodigo(C);
+      break;
+    case 23:
+      reordenarCircuito(C);
+      break;
+    case 24:
+      simularHierarquico();
+      break;
+    default:
+      break;
+    }
+  } while(opcao != 0);
+}
+
+void gerarSintetico()
+{
+  ParamGerador P;
+  string nome;
+  unsigned n, k;
+  double peso;
+
+  do {
+    cout << "Numero de entradas, saidas e portas: ";
+    cin >> P.Nin >> P.Nout >> P.Nportas;
+    cout << "Profundidade (numero de niveis): ";
+    cin >> P.profundidade;
+    cout << "Fracao de portas fora de ordem (0 a 1): ";
+    cin >> P.fracForaOrdem;
+    cout << "Fracao de portas com realimentacao (0 a 1): ";
+    cin >> P.fracRealimentacao;
+    cout << "Semente: ";
+    cin >> P.semente;
+    cout << "Numero minimo de entradas das portas (exceto NOT) e quantidade de pesos: ";
+    cin >> P.fanInMin >> n;
+    cout << "Pesos das portas com " << P.fanInMin << ", " << P.fanInMin+1 << ", ... entradas: ";
+    P.pesosFanIn.clear();
+    for (k=0; k<n && cin; k++)
+    {
+      cin >> peso;
+      P.pesosFanIn.push_back(peso);
+    }
+    cout << "Pesos dos tipos NT AN NA OR NO XO NX: ";
+    for (k=0; k<NUM_TIPOS_GERADOR; k++) cin >> P.pesosTipo[k];
+    if (!P.valid()) cerr << "Parametros invalidos para o gerador\n";
+  } while (!P.valid());
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo: ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!gerarCircuito(P,nome))
+  {
+    cerr << "Arquivo " << nome << " invalido para escrita\n";
+  }
+}
+
+void simularFalhas(const Circuit& C)
+{
+  SimuladorConcorrente S;
+  vector<vector<bool3S>> vetores;
+  string nome;
+
+  if (!S.inicializar(C))
+  {
+    cerr << "Circuito invalido para simulacao de falhas\n";
+    return;
+  }
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo de estimulos: ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!lerEstimulos(nome, C.getNumInputs(), vetores))
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+  S.simular(vetores);
+  S.imprimirRelatorio(cout, true);
+}
+
+void simularAtrasos(const Circuit& C)
+{
+  SimuladorAtraso S;
+  vector<vector<bool3S>> vetores;
+  string nome;
+  unsigned i;
+
+  if (!S.inicializar(C))
+  {
+    cerr << "Circuito invalido para simulacao com atrasos\n";
+    return;
+  }
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo de estimulos: ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!lerEstimulos(nome, C.getNumInputs(), vetores))
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+
+  // Para cada vetor: entradas, saidas finais, instante de acomodacao e glitches de cada saida
+  cout << "ENTRADAS" << '\t' << "SAIDAS" << '\t' << "ACOMODACAO" << '\t' << "GLITCHES" << endl;
+  for (const vector<bool3S>& in_circ : vetores)
+  {
+    S.simular(in_circ);
+    for (i=0; i<C.getNumInputs(); i++) cout << in_circ[i] << (i+1<C.getNumInputs() ? ' ' : '\t');
+    for (i=1; i<=C.getNumOutputs(); i++) cout << S.getOutput(i) << (i<C.getNumOutputs() ? ' ' : '\t');
+    for (i=1; i<=C.getNumOutputs(); i++) cout << S.getAcomodacao(i) << (i<C.getNumOutputs() ? ' ' : '\t');
+    for (i=1; i<=C.getNumOutputs(); i++) cout << S.getGlitches(i) << (i<C.getNumOutputs() ? ' ' : '\n');
+  }
+}
+
+void simularCiclos(const Circuit& C)
+{
+  SimuladorCiclos S;
+  vector<vector<bool3S>> vetores, saidas;
+  vector<bool3S> estado;
+  string nome, linha;
+  unsigned i;
+
+  if (!S.inicializar(C))
+  {
+    cerr << "Circuito invalido para simulacao de ciclos\n";
+    return;
+  }
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo de estimulos (um vetor por ciclo): ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!lerEstimulos(nome, C.getNumInputs(), vetores))
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+  // Vetor de reset opcional (linha vazia: todos os flip-flops em UNDEF)
+  if (S.getNumFlipFlops() > 0)
+  {
+    do {
+      cout << "Estado inicial dos " << S.getNumFlipFlops() << " flip-flops (ENTER para UNDEF): ";
+      getline(cin,linha);
+      istringstream I(linha);
+      if (linha.find_first_not_of(" \t") == string::npos) estado.clear();
+      else if (!lerEstimulo(I, S.getNumFlipFlops(), estado)) continue;
+      break;
+    } while (true);
+    if (!estado.empty()) S.reset(estado);
+  }
+  S.simular(vetores, saidas);
+
+  // Para cada ciclo: entradas e saidas; no final, o estado dos flip-flops
+  cout << "CICLO" << '\t' << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  for (unsigned k=0; k<vetores.size(); k++)
+  {
+    cout << k+1 << '\t';
+    for (i=0; i<C.getNumInputs(); i++) cout << vetores[k][i] << (i+1<C.getNumInputs() ? ' ' : '\t');
+    for (i=0; i<C.getNumOutputs(); i++) cout << saidas[k][i] << (i+1<C.getNumOutputs() ? ' ' : '\n');
+  }
+  estado = S.getEstado();
+  cout << "ESTADO FINAL:";
+  for (i=0; i<estado.size(); i++) cout << ' ' << estado[i];
+  cout << endl;
+}
+
+void verificarEquivalencia(const Circuit& C)
+{
+  Circuit B;
+  ResultadoEquivalencia R;
+  string nome;
+  int modo;
+
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo com o circuito a comparar: ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!B.ler(nome))
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+  do {
+    cout << "Modo (0 - automatico; 1 - exaustivo; 2 - vetores aleatorios): ";
+    cin >> modo;
+  } while (modo<0 || modo>2);
+  // Automatico: todos os vetores se couber no orcamento; senao, casos extremos e vetores aleatorios
+  if (verificarEquivalenciaModo(C, B, R, ModoEquivalencia(modo))) cout << R;
+}
+
+void executarServidor(const Circuit& C)
+{
+  ServidorSimulacao S;
+  string caminho, linha, nome, arq;
+
+  // Antes de ler a string com o caminho do socket, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Caminho do socket: ";
+    getline(cin,caminho);
+  } while (caminho.size() < 1);
+  // O circuito atual (se valido) fica disponivel com o nome "atual"
+  if (C.valid() && S.registrar("atual", C)) cout << "Circuito atual registrado como \"atual\"\n";
+  cout << "Outros circuitos (uma linha \"nome arquivo\" por circuito; linha vazia para terminar):\n";
+  while (getline(cin,linha) && !linha.empty())
+  {
+    istringstream I(linha);
+    if (!(I >> nome >> arq))
+    {
+      cerr << "Linha invalida: " << linha << endl;
+      continue;
+    }
+    if (S.carregar(nome, arq)) cout << "Circuito \"" << nome << "\" carregado\n";
+  }
+  if (S.getNumCircuitos()==0)
+  {
+    cerr << "Nenhum circuito para servir\n";
+    return;
+  }
+  if (!S.iniciar(caminho)) return;
+  cout << "Servidor em " << caminho << " (ateh receber DESLIGAR)\n";
+  S.executar();
+  cout << S.getNumPedidos() << " pedido(s) SIMULAR em " << S.getNumLotes() << " lote(s)\n";
+}
+
+void estimarAtividade(const Circuit& C)
+{
+  ParamAtividade P;
+  ResultadoAtividade R;
+  string nome;
+
+  do {
+    cout << "Numero maximo de amostras: ";
+    cin >> P.maxAmostras;
+  } while (P.maxAmostras == 0);
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo com as probabilidades das entradas (ENTER para 0.5): ";
+    getline(cin,nome);
+    if (nome.empty()) break;
+  } while (!P.lerProbabilidades(nome, C.getNumInputs()));
+  if (estimarAtividade(C, P, R)) cout << R;
+}
+
+void gerarTabelaRestrita(const Circuit& C)
+{
+  vector<DominioEntrada> D;
+  string linha;
+
+  // Antes de ler a string com as restricoes, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Restricoes (por exemplo -1=T, -3=F, -2=FT; ENTER para nenhuma): ";
+    getline(cin,linha);
+  } while (!lerDominios(linha, C.getNumInputs(), D));
+  gerarTabelaRestrita(C, D);
+}
+
+void justificarSaidas(const Circuit& C)
+{
+  Justificador J;
+  vector<bool3S> Alvo;
+  ResultadoJustificacao R;
+  string linha;
+  char todos;
+
+  if (!J.inicializar(C))
+  {
+    cerr << "Circuito invalido para justificacao\n";
+    return;
+  }
+  // Antes de ler a string com os alvos, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Valores das saidas (por exemplo 1=T, 3=F): ";
+    getline(cin,linha);
+  } while (!lerAlvos(linha, J.getNumOutputs(), Alvo));
+  do {
+    cout << "Procurar todos os cubos (S/N)? ";
+    cin >> todos;
+    todos = toupper(todos);
+  } while (todos!='S' && todos!='N');
+  if (J.justificar(Alvo, R, (todos=='S') ? ~0ULL : 1)) cout << R;
+}
+
+void tabularCircuito(Circuit& C)
+{
+  size_t limite;
+
+  cout << "Limite de memoria da tabela em KB (0 para desligar): ";
+  cin >> limite;
+  C.tabular(limite*1024);
+  C.imprimirTabulacao();
+}
+
+void mapearLUTs(const Circuit& C)
+{
+  RedeLUT R;
+  unsigned K;
+  string nome;
+
+  do {
+    cout << "Numero maximo de entradas de cada LUT (1 a " << MAX_K_LUT << "): ";
+    cin >> K;
+  } while (K<1 || K>MAX_K_LUT);
+  // A rede eh conferida com o circuito original antes de ser usada
+  if (!R.mapear(C, K) || !R.conferir(C)) return;
+  cout << R;
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  cout << "Arquivo de estimulos para simular pela rede (vazio para nenhum): ";
+  getline(cin,nome);
+  if (nome.empty()) return;
+  ifstream arquivo(nome);
+  if (!arquivo.is_open())
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+  cout << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  R.simularEstimulos(arquivo, cout);
+}
+
+void gerarCodigo(const Circuit& C)
+{
+  string nome, arq;
+
+  cout << "Nome do namespace do codigo gerado: ";
+  cin >> nome;
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  cout << "Arquivo de saida (.h): ";
+  getline(cin,arq);
+  ofstream O(arq);
+  if (!O.is_open())
+  {
+    cerr << "Arquivo " << arq << " invalido para escrita\n";
+    return;
+  }
+  if (gerarCodigoCpp(C, nome, O)) cout << "Codigo gerado em " << arq << '\n';
+}
+
+void reordenarCircuito(Circuit& C)
+{
+  if (reordenarPortas(C)) cout << "Portas reordenadas (salve o circuito para manter a nova ordem)\n";
+  else cerr << "Circuito invalido para reordenacao\n";
+}
+
+void simularHierarquico()
+{
+  CircuitoHierarquico H;
+  string nome;
+
+  // Antes de ler a string com o nome do arquivo, esvaziar o buffer do teclado
+  cin.ignore(256,'\n');
+  do {
+    cout << "Arquivo do circuito hierarquico: ";
+    getline(cin,nome);
+  } while (nome.size() < 3); // Name do arquivo >= 3 caracteres
+  if (!H.ler(nome))
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+  do {
+    cout << "Arquivo de estimulos: ";
+    getline(cin,nome);
+  } while (nome.size() < 3);
+  ifstream arquivo(nome);
+  if (!arquivo.is_open())
+  {
+    cerr << "Arquivo " << nome << " invalido para leitura\n";
+    return;
+  }
+
+  // Uma linha "entradas TAB saidas" por vetor, como no subcomando simular
+  cout << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  H.simularEstimulos(arquivo, cout);
+}
@@ -0,0 +1,183 @@
+#include <cctype>
+#include <vector>
+#include "codigocpp.h"
+#include "netlist.h"
+#include "rastro.h"
+
+// Numero de portas por funcao do codigo gerado (funcoes muito grandes sao lentas de compilar)
+static const unsigned PORTAS_BLOCO_CODIGO = 64;
+
+// Retorna true se Nome eh um identificador C++ (letras, digitos e _, sem comecar por digito)
+static bool identificadorValido(const std::string& Nome)
+{
+  if (Nome.empty() || std::isdigit((unsigned char)Nome[0])) return false;
+  for (char c : Nome)
+  {
+    if (!std::isalnum((unsigned char)c) && c!='_') return false;
+  }
+  return true;
+}
+
+// Definicoes fixas do cabecalho gerado (tipos e operadores de 3 estados)
+static const char* DEFINICOES =
+  "// Um valor de 3 estados em dois trilhos: t (TRUE), f (FALSE) ou nenhum dos dois (?)\n"
+  "struct Valor {bool t, f;};\n"
+  "// 64 valores de 3 estados, um por bit (pista)\n"
+  "struct Pistas {uint64_t t, f;};\n"
+  "\n"
+  "constexpr Valor operator~(Valor X) {return {X.f, X.t};}\n"
+  "constexpr Valor operator&(Valor X, Valor Y) {return {X.t && Y.t, X.f || Y.f};}\n"
+  "constexpr Valor operator|(Valor X, Valor Y) {return {X.t || Y.t, X.f && Y.f};}\n"
+  "constexpr Valor operator^(Valor X, Valor Y)\n"
+  "{\n"
+  "  return {(X.t || X.f) && (Y.t || Y.f) && X.t!=Y.t, (X.t || X.f) && (Y.t || Y.f) && X.t==Y.t};\n"
+  "}\n"
+  "constexpr bool operator==(Valor X, Valor Y) {return X.t==Y.t && X.f==Y.f;}\n"
+  "\n"
+  "constexpr Pistas operator~(Pistas X) {return {X.f, X.t};}\n"
+  "constexpr Pistas operator&(Pistas X, Pistas Y) {return {X.t & Y.t, X.f | Y.f};}\n"
+  "constexpr Pistas operator|(Pistas X, Pistas Y) {return {X.t | Y.t, X.f & Y.f};}\n"
+  "constexpr Pistas operator^(Pistas X, Pistas Y)\n"
+  "{\n"
+  "  return {(X.t ^ Y.t) & (X.t | X.f) & (Y.t | Y.f), ~(X.t ^ Y.t) & (X.t | X.f) & (Y.t | Y.f)};\n"
+  "}\n"
+  "constexpr bool operator==(Pistas X, Pistas Y) {return X.t==Y.t && X.f==Y.f;}\n"
+  "\n"
+  "// Conversao de e para a codificacao de bool3S: 0 (?), 1 (F), 2 (T)\n"
+  "constexpr unsigned codigo(Valor X) {return X.t ? 2 : (X.f ? 1 : 0);}\n"
+  "constexpr Valor deCodigo(unsigned C) {return {C==2, C==1};}\n";
+
+bool gerarCodigoCpp(const Circuit& C, const std::string& Nome, std::ostream& O)
+{
+  RASTRO_ESCOPO("gerar codigo C++");
+  if (!identificadorValido(Nome))
+  {
+    std::cerr << "Nome invalido para o namespace: " << Nome << "\n";
+    return false;
+  }
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    std::cerr << "Circuito invalido para geracao de codigo\n";
+    return false;
+  }
+  if (!N.getFlipFlops().empty())
+  {
+    std::cerr << "Circuitos com flip-flops nao sao suportados na geracao de codigo\n";
+    return false;
+  }
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  const std::vector<unsigned>& ordem = N.getOrdem();
+
+  // Sinais usados (no cone de alguma saida)
+  std::vector<bool> usado(N.getNumSinais(), false);
+  std::vector<unsigned> pilha;
+  for (unsigned j=0; j<Nout; j++) pilha.push_back(N.getSaida(j));
+  while (!pilha.empty())
+  {
+    unsigned S = pilha.back();
+    pilha.pop_back();
+    if (usado[S]) continue;
+    usado[S] = true;
+    if (S<Nin) continue;
+    const unsigned* e = N.getEntradas(S-Nin);
+    pilha.insert(pilha.end(), e, e+N.getNumInputsPort(S-Nin));
+  }
+  // Indice de cada sinal no vetor v do codigo gerado: as entradas e depois as portas
+  // usadas, na ordem de avaliacao
+  std::vector<unsigned> indice(N.getNumSinais(), 0);
+  std::vector<unsigned> portas;
+  for (unsigned i=0; i<Nin; i++) indice[i] = i;
+  for (unsigned k=0; k<ordem.size(); k++)
+  {
+    unsigned P = ordem[k];
+    if (!usado[Nin+P]) continue;
+    indice[Nin+P] = Nin+portas.size();
+    portas.push_back(P);
+  }
+  const unsigned numSinais = Nin+portas.size();
+  // Portas usadas sem lacos (as primeiras de portas)
+  unsigned numSemLaco = 0;
+  for (unsigned k=0; k<N.getInicioLaco(); k++) numSemLaco += usado[Nin+ordem[k]];
+
+  auto variavel = [&](unsigned S) {return "v[" + std::to_string(indice[S]) + "]";};
+  // Expressao da saida da porta P
+  auto expressao = [&](unsigned P)
+  {
+    const unsigned* e = N.getEntradas(P);
+    const unsigned n = N.getNumInputsPort(P);
+    TipoPorta t = N.getTipo(P);
+    if (t==TipoPorta::NT) return "~"+variavel(e[0]);
+    const char* op = (t==TipoPorta::AN || t==TipoPorta::NA) ? " & " :
+                     (t==TipoPorta::OR || t==TipoPorta::NO) ? " | " : " ^ ";
+    std::string x = variavel(e[0]);
+    for (unsigned k=1; k<n; k++) x += op + variavel(e[k]);
+    if (t==TipoPorta::NA || t==TipoPorta::NO || t==TipoPorta::NX) return "~(" + x + ")";
+    return x;
+  };
+
+  std::string guarda = "_CIRCUITO_";
+  for (char c : Nome) guarda += char(std::toupper((unsigned char)c));
+  guarda += "_H_";
+
+  O << "// Codigo gerado para um circuito com " << Nin << " entrada(s), " << Nout << " saida(s) e "
+    << N.getNumPorts() << " porta(s) (" << portas.size() << " usada(s))\n"
+    << "// Nao editar: gerar novamente a partir do circuito\n"
+    << "#ifndef " << guarda << "\n#define " << guarda << "\n\n"
+    << "#include <cstdint>\n\n"
+    << "namespace " << Nome << " {\n\n"
+    << "const unsigned NUM_ENTRADAS = " << Nin << ";\n"
+    << "const unsigned NUM_SAIDAS = " << Nout << ";\n"
+    << "// Numero de valores intermediarios (entradas e portas usadas)\n"
+    << "const unsigned NUM_SINAIS = " << numSinais << ";\n\n"
+    << DEFINICOES << "\n";
+
+  // Blocos de portas sem lacos: uma atribuicao por porta
+  unsigned numBlocos = 0;
+  for (unsigned k0=0; k0<numSemLaco; k0+=PORTAS_BLOCO_CODIGO, numBlocos++)
+  {
+    O << "template <class T>\nconstexpr void bloco" << numBlocos << "(T* v)\n{\n";
+    for (unsigned k=k0; k<numSemLaco && k<k0+PORTAS_BLOCO_CODIGO; k++)
+    {
+      O << "  " << variavel(Nin+portas[k]) << " = " << expressao(portas[k]) << ";\n";
+    }
+    O << "}\n\n";
+  }
+  // Blocos de portas em lacos: retornam true se algum valor mudou
+  unsigned numBlocosLaco = 0;
+  for (unsigned k0=numSemLaco; k0<portas.size(); k0+=PORTAS_BLOCO_CODIGO, numBlocosLaco++)
+  {
+    O << "template <class T>\nconstexpr bool laco" << numBlocosLaco << "(T* v)\n{\n  bool mudou = false;\n";
+    for (unsigned k=k0; k<portas.size() && k<k0+PORTAS_BLOCO_CODIGO; k++)
+    {
+      std::string x = variavel(Nin+portas[k]);
+      O << "  {const T x = " << expressao(portas[k]) << "; mudou = mudou || !(x==" << x << "); " << x << " = x;}\n";
+    }
+    O << "  return mudou;\n}\n\n";
+  }
+
+  O << "// Avalia o circuito: In tem NUM_ENTRADAS valores e Out, NUM_SAIDAS valores\n"
+    << "template <class T>\n"
+    << "constexpr void avaliarGenerico(const T* In, T* Out)\n{\n"
+    << "  T v[NUM_SINAIS] = {};\n"
+    << "  for (unsigned i=0; i<NUM_ENTRADAS; i++) v[i] = In[i];\n";
+  for (unsigned b=0; b<numBlocos; b++) O << "  bloco" << b << "(v);\n";
+  if (numBlocosLaco>0)
+  {
+    // As portas em lacos partem de ? (v eh inicializado com {})
+    O << "  // Portas em lacos: reavaliadas ateh o ponto fixo, partindo de ?\n"
+      << "  for (bool mudou = true; mudou; )\n  {\n    mudou = false;\n";
+    for (unsigned b=0; b<numBlocosLaco; b++) O << "    if (laco" << b << "(v)) mudou = true;\n";
+    O << "  }\n";
+  }
+  for (unsigned j=0; j<Nout; j++) O << "  Out[" << j << "] = " << variavel(N.getSaida(j)) << ";\n";
+  O << "}\n\n"
+    << "// Avalia um vetor de entradas (pode ser usada em expressoes constantes)\n"
+    << "constexpr void avaliar(const Valor* In, Valor* Out) {avaliarGenerico(In, Out);}\n"
+    << "// Avalia 64 vetores de entradas (um por pista)\n"
+    << "inline void avaliar64(const Pistas* In, Pistas* Out) {avaliarGenerico(In, Out);}\n\n"
+    << "} // namespace " << Nome << "\n\n"
+    << "#endif // " << guarda << "\n";
+  return bool(O);
+}
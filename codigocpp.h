@@ -0,0 +1,35 @@
+#ifndef _CODIGOCPP_H_
+#define _CODIGOCPP_H_
+
+#include <iostream>
+#include <string>
+#include "circuit.h"
+
+///
+/// GERACAO DE CODIGO C++ PARA UM CIRCUITO FIXO
+///
+
+// Gera um cabecalho C++ independente (sem dependencias deste projeto) que avalia o
+// circuito com codigo em linha reta, sem interpretar a netlist: uma atribuicao por porta,
+// na ordem de avaliacao, e apenas as portas que alimentam alguma saida. As atribuicoes
+// sao divididas em funcoes de algumas dezenas de portas (PORTAS_BLOCO_CODIGO), porque
+// os compiladores sao muito lentos para otimizar uma unica funcao enorme.
+//
+// O cabecalho gerado define, no namespace Nome:
+// - NUM_ENTRADAS, NUM_SAIDAS e NUM_SINAIS (entradas mais portas usadas);
+// - Valor {bool t, f}: um valor de 3 estados em dois trilhos (como bool3S_64, com uma
+//   pista), com codigo(V) e deCodigo(C) para a codificacao de bool3S (0: ?, 1: F, 2: T);
+// - Pistas {uint64_t t, f}: 64 valores (mesma codificacao de bool3S_64);
+// - constexpr void avaliar(const Valor* In, Valor* Out): avalia um vetor (pode ser usada
+//   em expressoes constantes);
+// - inline void avaliar64(const Pistas* In, Pistas* Out): avalia 64 vetores.
+// As duas funcoes usam o mesmo corpo (templates sobre o tipo do valor), com um vetor local
+// de NUM_SINAIS valores.
+// As portas em lacos de realimentacao sao reavaliadas ateh o ponto fixo, partindo de ?,
+// como em Netlist::simular. Circuitos com flip-flops nao sao suportados.
+
+// Escreve em O o cabecalho C++ do circuito C, no namespace Nome (um identificador C++)
+// Retorna false (com uma mensagem em cerr) se o circuito ou o nome for invalido
+bool gerarCodigoCpp(const Circuit& C, const std::string& Nome, std::ostream& O);
+
+#endif // _CODIGOCPP_H_
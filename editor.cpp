@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include "editor.h"
+#include "rastro.h"
+
+// A existencia de lacos eh verificada de novo depois de Nportas/FRACAO_VERIFICACAO_LACOS
+// ligacoes removidas
+static const unsigned FRACAO_VERIFICACAO_LACOS = 8;
+
+// Remove uma ocorrencia de X do vetor V
+static void removerUma(std::vector<unsigned>& V, unsigned X)
+{
+  std::vector<unsigned>::iterator it = std::find(V.begin(), V.end(), X);
+  if (it==V.end()) return;
+  *it = V.back();
+  V.pop_back();
+}
+
+///
+/// CLASSE EDITORCIRCUITO
+///
+
+EditorCircuito::EditorCircuito()
+{
+  carregar(Circuit());
+}
+
+// Edita uma copia do circuito C
+EditorCircuito::EditorCircuito(const Circuit& C)
+{
+  carregar(C);
+}
+
+// Passa a editar uma copia do circuito C
+void EditorCircuito::carregar(const Circuit& C0)
+{
+  RASTRO_ESCOPO("carregar editor");
+  C = C0;
+  Nin = C.getNumInputs();
+  const unsigned NP = C.getNumPorts();
+  tipo.assign(NP, TipoPorta::AN);
+  definida.assign(NP, false);
+  entradas.assign(NP, std::vector<int>());
+  valida.assign(NP, false);
+  numPortasInvalidas = NP;
+  numSaidasInvalidas = 0;
+  for (unsigned j=1; j<=C.getNumOutputs(); j++)
+  {
+    if (!C.validIdOrig(C.getIdOutput(j))) numSaidasInvalidas++;
+  }
+  fanout.assign(Nin+NP, std::vector<unsigned>());
+  ordem.resize(NP);
+  valor.assign(Nin+NP, bool3S::UNDEF);
+  simulado = false;
+  sujas.clear();
+  suja.assign(NP, false);
+  avaliacoes = 0;
+  marca.assign(NP, false);
+  // Sem manter a ordem a cada porta: ela eh calculada de uma vez no final
+  lacos = true;
+  for (unsigned P=0; P<NP; P++) atualizarPorta(P);
+  recalcularOrdem();
+}
+
+// Mesmo resultado de Circuit::valid
+bool EditorCircuito::valid() const
+{
+  return Nin>0 && C.getNumOutputs()>0 && C.getNumPorts()>0 &&
+         numPortasInvalidas==0 && numSaidasInvalidas==0;
+}
+
+/// ***********************
+/// Modificacoes
+/// ***********************
+
+void EditorCircuito::setIdOutput(int IdOut, int IdOrig)
+{
+  if (!C.validIdOutput(IdOut)) return;
+  bool antes = C.validIdOrig(C.getIdOutput(IdOut));
+  C.setIdOutput(IdOut, IdOrig);
+  bool depois = C.validIdOrig(C.getIdOutput(IdOut));
+  if (antes && !depois) numSaidasInvalidas++;
+  if (!antes && depois) numSaidasInvalidas--;
+}
+
+void EditorCircuito::setPort(int IdPort, const std::string& Tipo, unsigned NIn)
+{
+  unsigned long long versao = C.getVersao();
+  C.setPort(IdPort, Tipo, NIn);
+  if (C.getVersao()!=versao) atualizarPorta(IdPort-1);
+}
+
+void EditorCircuito::setId_inPort(int IdPort, unsigned I, int IdOrig)
+{
+  unsigned long long versao = C.getVersao();
+  C.setId_inPort(IdPort, I, IdOrig);
+  if (C.getVersao()!=versao) atualizarPorta(IdPort-1);
+}
+
+// Atualiza as estruturas da porta P a partir de C
+void EditorCircuito::atualizarPorta(unsigned P)
+{
+  const int Id = P+1;
+  // Retira as ligacoes antigas
+  if (consumidora(P))
+  {
+    for (int IdOrig : entradas[P])
+    {
+      if (!C.validIdOrig(IdOrig)) continue;
+      removerUma(fanout[sinal(IdOrig)], P);
+      if (IdOrig>0) removidas++;
+    }
+  }
+  // Leh a porta
+  const bool validaAntes = valida[P];
+  definida[P] = C.definedPort(Id);
+  entradas[P].clear();
+  if (definida[P])
+  {
+    tipoPorta(C.getNamePort(Id), tipo[P]);
+    for (unsigned j=0; j<C.getNumInputsPort(Id); j++) entradas[P].push_back(C.getId_inPort(Id, j));
+  }
+  valida[P] = C.validPort(Id);
+  if (validaAntes && !valida[P]) numPortasInvalidas++;
+  if (!validaAntes && valida[P]) numPortasInvalidas--;
+  // Inclui as ligacoes novas
+  if (consumidora(P))
+  {
+    for (int IdOrig : entradas[P])
+    {
+      if (!C.validIdOrig(IdOrig)) continue;
+      fanout[sinal(IdOrig)].push_back(P);
+      if (IdOrig>0 && !lacos && !incluirLigacao(unsigned(IdOrig)-1, P)) lacos = true;
+    }
+  }
+  sujar(P);
+}
+
+// Marca a porta P para reavaliacao
+void EditorCircuito::sujar(unsigned P)
+{
+  if (suja[P]) return;
+  suja[P] = true;
+  sujas.push_back(P);
+}
+
+/// ***********************
+/// Ordem topologica
+/// ***********************
+
+// Inclui a ligacao da porta U para a porta V (algoritmo de Pearce-Kelly): se U estiver
+// depois de V, as portas alcancaveis a partir de V (para frente) e as que alcancam U
+// (para tras), entre as posicoes de V e de U, trocam de posicoes entre si, ficando as
+// de tras antes das da frente
+bool EditorCircuito::incluirLigacao(unsigned U, unsigned V)
+{
+  if (U==V) return false;
+  if (ordem[U]<ordem[V]) return true;
+  const unsigned inf = ordem[V], sup = ordem[U];
+  std::vector<unsigned> frente, tras, pilha;
+  bool laco = false;
+
+  // Para frente, a partir de V: se alcancar U, ha um laco
+  pilha.push_back(V);
+  marca[V] = true;
+  while (!pilha.empty() && !laco)
+  {
+    unsigned X = pilha.back();
+    pilha.pop_back();
+    frente.push_back(X);
+    for (unsigned Q : fanout[Nin+X])
+    {
+      if (Q==U) {laco = true; break;}
+      if (!marca[Q] && ordem[Q]<sup)
+      {
+        marca[Q] = true;
+        pilha.push_back(Q);
+      }
+    }
+  }
+  if (laco)
+  {
+    for (unsigned X : frente) marca[X] = false;
+    for (unsigned X : pilha) marca[X] = false;
+    return false;
+  }
+  // Para tras, a partir de U
+  pilha.push_back(U);
+  marca[U] = true;
+  while (!pilha.empty())
+  {
+    unsigned X = pilha.back();
+    pilha.pop_back();
+    tras.push_back(X);
+    if (!consumidora(X)) continue;
+    for (int IdOrig : entradas[X])
+    {
+      if (IdOrig<=0 || !C.validIdPort(IdOrig)) continue;
+      unsigned Q = unsigned(IdOrig)-1;
+      if (!marca[Q] && ordem[Q]>inf)
+      {
+        marca[Q] = true;
+        pilha.push_back(Q);
+      }
+    }
+  }
+  // Reordenacao: as posicoes do conjunto, em ordem, vao primeiro para as portas de tras
+  auto antes = [&](unsigned A, unsigned B) {return ordem[A]<ordem[B];};
+  std::sort(tras.begin(), tras.end(), antes);
+  std::sort(frente.begin(), frente.end(), antes);
+  std::vector<unsigned> posicoes;
+  for (unsigned X : tras) posicoes.push_back(ordem[X]);
+  for (unsigned X : frente) posicoes.push_back(ordem[X]);
+  std::sort(posicoes.begin(), posicoes.end());
+  unsigned k = 0;
+  for (unsigned X : tras) {ordem[X] = posicoes[k++]; marca[X] = false;}
+  for (unsigned X : frente) {ordem[X] = posicoes[k++]; marca[X] = false;}
+  return true;
+}
+
+// Recalcula a ordem topologica inteira (algoritmo de Kahn)
+void EditorCircuito::recalcularOrdem()
+{
+  RASTRO_ESCOPO("ordenar editor");
+  const unsigned NP = C.getNumPorts();
+  std::vector<unsigned> falta(NP, 0), prontas;
+  for (unsigned P=0; P<NP; P++)
+  {
+    if (!consumidora(P)) continue;
+    for (int IdOrig : entradas[P]) if (IdOrig>0 && C.validIdPort(IdOrig)) falta[P]++;
+  }
+  for (unsigned P=0; P<NP; P++) if (falta[P]==0) prontas.push_back(P);
+  for (unsigned i=0; i<prontas.size(); i++)
+  {
+    unsigned P = prontas[i];
+    ordem[P] = i;
+    for (unsigned Q : fanout[Nin+P]) if (--falta[Q]==0) prontas.push_back(Q);
+  }
+  // As portas que sobraram estao em lacos (ou dependem deles)
+  unsigned k = prontas.size();
+  lacos = (k<NP);
+  for (unsigned P=0; P<NP; P++) if (falta[P]!=0) ordem[P] = k++;
+  removidas = 0;
+}
+
+/// ***********************
+/// Simulacao
+/// ***********************
+
+// Calcula a saida da porta P a partir dos valores atuais
+bool3S EditorCircuito::avaliar(unsigned P)
+{
+  if (!valida[P] || tipo[P]==TipoPorta::FF) return bool3S::UNDEF;
+  const std::vector<int>& e = entradas[P];
+  entrPorta.resize(e.size());
+  for (unsigned j=0; j<e.size(); j++) entrPorta[j] = valor[sinal(e[j])];
+  return avaliarPorta(tipo[P], entrPorta.data(), e.size());
+}
+
+// Reavalia as portas sujas na ordem topologica, propagando apenas as mudancas
+void EditorCircuito::propagarOrdem()
+{
+  typedef std::pair<unsigned, unsigned> Item;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> fila;
+  for (unsigned P : sujas) fila.push(Item(ordem[P], P));
+  sujas.clear();
+  while (!fila.empty())
+  {
+    unsigned P = fila.top().second;
+    fila.pop();
+    suja[P] = false;
+    bool3S v = avaliar(P);
+    avaliacoes++;
+    if (v==valor[Nin+P]) continue;
+    valor[Nin+P] = v;
+    for (unsigned Q : fanout[Nin+P])
+    {
+      if (suja[Q]) continue;
+      suja[Q] = true;
+      fila.push(Item(ordem[Q], Q));
+    }
+  }
+}
+
+// Reavalia o cone de fanout das portas sujas ateh o ponto fixo, partindo de UNDEF
+void EditorCircuito::propagarCone()
+{
+  std::vector<unsigned> cone;
+  cone.swap(sujas);
+  for (unsigned i=0; i<cone.size(); i++)
+  {
+    for (unsigned Q : fanout[Nin+cone[i]])
+    {
+      if (suja[Q]) continue;
+      suja[Q] = true;
+      cone.push_back(Q);
+    }
+  }
+  for (unsigned P : cone) valor[Nin+P] = bool3S::UNDEF;
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned P : cone)
+    {
+      bool3S v = avaliar(P);
+      avaliacoes++;
+      if (v!=valor[Nin+P])
+      {
+        valor[Nin+P] = v;
+        mudou = true;
+      }
+    }
+  } while (mudou);
+  for (unsigned P : cone) suja[P] = false;
+}
+
+// Simula o circuito para o vetor de entradas in_circ
+bool EditorCircuito::simular(const std::vector<bool3S>& in_circ)
+{
+  if (!valid() || in_circ.size()!=Nin) return false;
+  if (lacos && removidas*FRACAO_VERIFICACAO_LACOS >= C.getNumPorts()) recalcularOrdem();
+  for (unsigned i=0; i<Nin; i++)
+  {
+    if (simulado && in_circ[i]==valor[i]) continue;
+    valor[i] = in_circ[i];
+    for (unsigned Q : fanout[i]) sujar(Q);
+  }
+  simulado = true;
+  avaliacoes = 0;
+  if (lacos) propagarCone();
+  else propagarOrdem();
+  return true;
+}
+
+// Simula de novo o ultimo vetor de entradas
+bool EditorCircuito::simular()
+{
+  if (!simulado) return false;
+  return simular(std::vector<bool3S>(valor.begin(), valor.begin()+Nin));
+}
+
+// Valor da saida IdOutput na ultima simulacao
+bool3S EditorCircuito::getOutput(int IdOutput) const
+{
+  if (!C.validIdOutput(IdOutput)) return bool3S::UNDEF;
+  int IdOrig = C.getIdOutput(IdOutput);
+  if (!C.validIdOrig(IdOrig)) return bool3S::UNDEF;
+  return valor[sinal(IdOrig)];
+}
+
+// Valor da porta IdPort na ultima simulacao
+bool3S EditorCircuito::getValorPorta(int IdPort) const
+{
+  if (!C.validIdPort(IdPort)) return bool3S::UNDEF;
+  return valor[Nin+IdPort-1];
+}
+
+// Ids das portas alimentadas pelo sinal de id IdOrig
+std::vector<int> EditorCircuito::getFanout(int IdOrig) const
+{
+  std::vector<int> ids;
+  if (!C.validIdOrig(IdOrig)) return ids;
+  for (unsigned Q : fanout[sinal(IdOrig)]) ids.push_back(int(Q)+1);
+  return ids;
+}
@@ -0,0 +1,128 @@
+#ifndef _EDITOR_H_
+#define _EDITOR_H_
+
+#include <string>
+#include <vector>
+#include "bool3S.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// EDICAO INCREMENTAL DE UM CIRCUITO
+///
+
+// Mantem um circuito e, a cada modificacao (setPort, setId_inPort, setIdOutput, com a
+// mesma interface e as mesmas verificacoes de Circuit), atualiza apenas o que a
+// modificacao afeta:
+// - validade: cada porta e cada saida sabe se eh valida, e o editor conta as invalidas,
+//   de modo que valid() nao percorre o circuito;
+// - fanout: a lista das portas alimentadas por cada sinal;
+// - ordem topologica das portas (algoritmo de Pearce-Kelly): uma ligacao nova que
+//   contraria a ordem soh reordena as portas entre as suas duas pontas;
+// - simulacao: o editor guarda o ultimo vetor de entradas e os valores de todas as portas.
+//   Uma nova simulacao reavalia apenas as portas modificadas (e as alimentadas por
+//   entradas que mudaram), na ordem topologica, e propaga para o fanout apenas quando
+//   o valor de uma porta muda.
+// O custo de uma modificacao seguida de uma simulacao depende do tamanho da regiao
+// afetada, e nao do tamanho do circuito.
+//
+// Os flip-flops sao fontes de sinal com valor UNDEF (como em Netlist) e quebram os lacos.
+// Se o circuito tiver lacos de realimentacao, nao ha ordem topologica: a simulacao
+// zera (UNDEF) todo o cone de fanout das portas modificadas e o reavalia ateh o ponto
+// fixo, como Circuit::simular. A existencia de lacos eh verificada de novo (por completo)
+// depois de um numero de ligacoes removidas proporcional ao numero de portas, de modo
+// que o custo dessa verificacao, dividido pelas modificacoes, eh constante.
+
+class EditorCircuito {
+private:
+  Circuit C;
+  unsigned Nin;
+  // Tipo, entradas (ids de origem) e validade de cada porta, copiados de C
+  std::vector<TipoPorta> tipo;
+  std::vector<bool> definida;
+  std::vector<std::vector<int>> entradas;
+  std::vector<bool> valida;
+  unsigned numPortasInvalidas;
+  unsigned numSaidasInvalidas;
+  // Portas alimentadas por cada sinal (indices de Netlist: entradas de 0 a Nin-1, porta P
+  // no sinal Nin+P); uma porta aparece uma vez para cada entrada ligada ao sinal
+  std::vector<std::vector<unsigned>> fanout;
+  // Posicao de cada porta na ordem topologica (sem lacos)
+  std::vector<unsigned> ordem;
+  // Ha lacos (a ordem nao eh mantida); ligacoes removidas desde a ultima verificacao
+  bool lacos;
+  unsigned removidas;
+  // Ultimo vetor de entradas (sinais 0 a Nin-1) e valores das portas (Nin+P)
+  std::vector<bool3S> valor;
+  bool simulado;
+  // Portas a reavaliar na proxima simulacao
+  std::vector<unsigned> sujas;
+  std::vector<bool> suja;
+  // Numero de portas avaliadas na ultima simulacao
+  unsigned avaliacoes;
+  // Marcas das buscas na ordem (sempre limpas ao final de cada busca)
+  std::vector<bool> marca;
+  // Valores das entradas da porta em avaliacao
+  std::vector<bool3S> entrPorta;
+
+  // Retorna true se as entradas da porta P contam no fanout e na ordem (porta definida
+  // que nao eh flip-flop)
+  bool consumidora(unsigned P) const {return definida[P] && tipo[P]!=TipoPorta::FF;}
+  // Sinal (indice) de uma id de origem valida
+  unsigned sinal(int IdOrig) const {return IdOrig<0 ? unsigned(-IdOrig-1) : Nin+unsigned(IdOrig)-1;}
+
+  // Atualiza as estruturas da porta P a partir de C (depois de uma modificacao)
+  void atualizarPorta(unsigned P);
+  // Marca a porta P para reavaliacao
+  void sujar(unsigned P);
+  // Inclui a ligacao da porta U para a porta V na ordem topologica
+  // Retorna false se a ligacao fechar um laco
+  bool incluirLigacao(unsigned U, unsigned V);
+  // Recalcula a ordem topologica inteira (e se ha lacos)
+  void recalcularOrdem();
+  // Calcula a saida da porta P a partir dos valores atuais
+  bool3S avaliar(unsigned P);
+  // Reavalia as portas sujas: na ordem topologica ou (com lacos) pelo cone de fanout
+  void propagarOrdem();
+  void propagarCone();
+
+public:
+  EditorCircuito();
+  // Edita uma copia do circuito C
+  explicit EditorCircuito(const Circuit& C);
+
+  // Passa a editar uma copia do circuito C (descarta a simulacao anterior)
+  void carregar(const Circuit& C);
+
+  // O circuito editado (por exemplo, para salvar)
+  const Circuit& getCircuit() const {return C;}
+
+  // Mesmo resultado de Circuit::valid, sem percorrer o circuito
+  bool valid() const;
+  // Retorna true se o circuito tem lacos de realimentacao (fora dos flip-flops)
+  bool realimentado() const {return lacos;}
+
+  // Modificacoes (mesma interface e mesmas verificacoes de Circuit)
+  void setIdOutput(int IdOut, int IdOrig);
+  void setPort(int IdPort, const std::string& Tipo, unsigned NIn);
+  void setId_inPort(int IdPort, unsigned I, int IdOrig);
+
+  // Ids das portas alimentadas pelo sinal de id IdOrig (uma vez por entrada ligada)
+  std::vector<int> getFanout(int IdOrig) const;
+
+  // Simula o circuito para o vetor de entradas in_circ, reavaliando apenas o que mudou
+  // desde a ultima simulacao (entradas e portas modificadas)
+  // Retorna false se o circuito ou a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ);
+  // Simula de novo o ultimo vetor de entradas (depois de modificacoes)
+  // Retorna false se o circuito for invalido ou se ainda nao houve simulacao
+  bool simular();
+
+  // Valor da saida IdOutput (ou da porta IdPort) na ultima simulacao
+  bool3S getOutput(int IdOutput) const;
+  bool3S getValorPorta(int IdPort) const;
+  // Numero de portas avaliadas na ultima simulacao
+  unsigned getNumAvaliacoes() const {return avaliacoes;}
+};
+
+#endif // _EDITOR_H_
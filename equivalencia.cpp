@@ -0,0 +1,320 @@
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include "equivalencia.h"
+#include "netlist.h"
+#include "rastro.h"
+
+ResultadoEquivalencia::ResultadoEquivalencia() {clear();}
+
+void ResultadoEquivalencia::clear()
+{
+  equivalentes = false;
+  exaustiva = false;
+  numVetores = 0;
+  contraExemplo.clear();
+  saidaDiferente = 0;
+  valorA = valorB = bool3S::UNDEF;
+}
+
+///
+/// Funcoes auxiliares
+///
+
+// Compila os dois circuitos e confere as dimensoes
+static bool compilarPar(const Circuit& A, const Circuit& B, Netlist& NA, Netlist& NB)
+{
+  if (!NA.compilar(A) || !NB.compilar(B))
+  {
+    std::cerr << "Circuito invalido para verificacao de equivalencia\n\n";
+    return false;
+  }
+  if (NA.getNumInputs()!=NB.getNumInputs() || NA.getNumOutputs()!=NB.getNumOutputs())
+  {
+    std::cerr << "Circuitos com numeros de entradas ou de saidas diferentes\n\n";
+    return false;
+  }
+  return true;
+}
+
+// Simula os dois circuitos com as entradas In (64 vetores) e retorna as pistas em que
+// alguma saida difere
+static uint64_t compararPalavra(const Netlist& NA, const Netlist& NB, const bool3S_64* In,
+                                std::vector<bool3S_64>& SA, std::vector<bool3S_64>& SB)
+{
+  for (unsigned i=0; i<NA.getNumInputs(); i++) SA[i] = SB[i] = In[i];
+  NA.simular(SA.data());
+  NB.simular(SB.data());
+  uint64_t dif = 0;
+  for (unsigned j=0; j<NA.getNumOutputs(); j++)
+  {
+    const bool3S_64& a = SA[NA.getSaida(j)];
+    const bool3S_64& b = SB[NB.getSaida(j)];
+    dif |= (a.t ^ b.t) | (a.f ^ b.f);
+  }
+  return dif;
+}
+
+// Preenche o contraexemplo com o vetor In e as saidas de cada circuito
+static void registrarContraExemplo(const Netlist& NA, const Netlist& NB,
+                                   const std::vector<bool3S>& In, ResultadoEquivalencia& R)
+{
+  std::vector<bool3S> outA, outB;
+  NA.simular(In, outA);
+  NB.simular(In, outB);
+  R.equivalentes = false;
+  R.contraExemplo = In;
+  for (unsigned j=0; j<outA.size(); j++)
+  {
+    if (outA[j]!=outB[j])
+    {
+      R.saidaDiferente = j+1;
+      R.valorA = outA[j];
+      R.valorB = outB[j];
+      break;
+    }
+  }
+}
+
+// Numero da pista menos significativa com bit 1 (X != 0)
+static unsigned primeiraPista(uint64_t X)
+{
+  unsigned k = 0;
+  while (((X >> k) & 1)==0) k++;
+  return k;
+}
+
+// Preenche as entradas da palavra W e retorna o numero de vetores (pistas) dela
+typedef std::function<unsigned(unsigned long long W, bool3S_64* In)> PreencherPalavra;
+
+// Simula os dois circuitos em todas as palavras, divididas entre NumThreads threads
+// (0: uma por nucleo). Cada thread pega blocos de palavras consecutivas, em ordem
+// crescente, e para quando jah ha um contraexemplo anterior ao bloco.
+// Retorna o indice (64*palavra+pista) do primeiro vetor em que as saidas diferem, ou
+// ~0 se nao houver
+static unsigned long long percorrer(const Netlist& NA, const Netlist& NB, unsigned long long NumPalavras,
+                                    unsigned NumThreads, const PreencherPalavra& Preencher)
+{
+  const unsigned long long PALAVRAS_BLOCO = 64;
+  std::atomic<unsigned long long> proximoBloco(0);
+  std::atomic<unsigned long long> menor(~0ULL);
+
+  auto trabalhador = [&]()
+  {
+    std::vector<bool3S_64> SA(NA.getNumSinais(), bool3S_64{0,0});
+    std::vector<bool3S_64> SB(NB.getNumSinais(), bool3S_64{0,0});
+    std::vector<bool3S_64> in(NA.getNumInputs());
+    while (true)
+    {
+      unsigned long long w0 = (proximoBloco++)*PALAVRAS_BLOCO;
+      if (w0>=NumPalavras || w0*64>=menor) break;
+      unsigned long long w1 = std::min(NumPalavras, w0+PALAVRAS_BLOCO);
+      for (unsigned long long w=w0; w<w1; w++)
+      {
+        unsigned pistas = Preencher(w, in.data());
+        uint64_t mascara = (pistas==64) ? ~uint64_t(0) : ((uint64_t(1) << pistas)-1);
+        uint64_t dif = compararPalavra(NA, NB, in.data(), SA, SB) & mascara;
+        if (dif!=0)
+        {
+          unsigned long long idx = w*64+primeiraPista(dif);
+          unsigned long long atual = menor.load();
+          while (idx<atual && !menor.compare_exchange_weak(atual, idx)) {}
+          break;
+        }
+      }
+    }
+  };
+
+  if (NumThreads==0) NumThreads = std::thread::hardware_concurrency();
+  if (NumThreads==0) NumThreads = 1;
+  std::vector<std::thread> threads;
+  for (unsigned t=1; t<NumThreads; t++) threads.emplace_back(trabalhador);
+  trabalhador();
+  for (std::thread& T : threads) T.join();
+  return menor;
+}
+
+// Completa o resultado a partir do indice do primeiro vetor diferente (ou ~0)
+static void concluir(const Netlist& NA, const Netlist& NB, unsigned long long Idx, unsigned long long Total,
+                     const PreencherPalavra& Preencher, ResultadoEquivalencia& R)
+{
+  if (Idx==~0ULL)
+  {
+    R.equivalentes = true;
+    R.numVetores = Total;
+    return;
+  }
+  std::vector<bool3S_64> in(NA.getNumInputs());
+  std::vector<bool3S> V(NA.getNumInputs());
+  Preencher(Idx/64, in.data());
+  for (unsigned i=0; i<V.size(); i++) V[i] = lerPista(in[i], Idx%64);
+  R.numVetores = Idx+1;
+  registrarContraExemplo(NA, NB, V, R);
+}
+
+// Gerador de numeros pseudoaleatorios (splitmix64) usado para que cada palavra aleatoria
+// dependa apenas da semente e do seu indice, qualquer que seja a thread que a simula
+static uint64_t espalhar(uint64_t X)
+{
+  X += 0x9E3779B97F4A7C15ULL;
+  X = (X ^ (X >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  X = (X ^ (X >> 27)) * 0x94D049BB133111EBULL;
+  return X ^ (X >> 31);
+}
+
+///
+/// Verificacao por vetores
+///
+
+bool verificarEquivalencia(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                           unsigned long long NumVetores, uint64_t Semente, unsigned NumThreads)
+{
+  RASTRO_ESCOPO("verificar equivalencia");
+  Netlist NA, NB;
+  R.clear();
+  if (!compilarPar(A, B, NA, NB)) return false;
+  const unsigned Nin = NA.getNumInputs();
+
+  // Casos extremos, em palavras no inicio da enumeracao
+  std::vector<std::vector<bool3S>> extremos;
+  extremos.push_back(std::vector<bool3S>(Nin, bool3S::FALSE));
+  extremos.push_back(std::vector<bool3S>(Nin, bool3S::TRUE));
+  extremos.push_back(std::vector<bool3S>(Nin, bool3S::UNDEF));
+  for (unsigned i=0; i<Nin; i++)
+  {
+    extremos.push_back(std::vector<bool3S>(Nin, bool3S::FALSE));
+    extremos.back()[i] = bool3S::TRUE;
+    extremos.push_back(std::vector<bool3S>(Nin, bool3S::TRUE));
+    extremos.back()[i] = bool3S::FALSE;
+  }
+  const unsigned long long palavrasExtremos = (extremos.size()+63)/64;
+  const unsigned long long palavrasAleat = (NumVetores+63)/64;
+
+  // Nas palavras aleatorias impares, cerca de 1/4 dos valores sao ?
+  PreencherPalavra preencher = [&](unsigned long long W, bool3S_64* In) -> unsigned
+  {
+    if (W<palavrasExtremos)
+    {
+      unsigned pistas = unsigned(std::min<unsigned long long>(64, extremos.size()-W*64));
+      for (unsigned i=0; i<Nin; i++)
+      {
+        In[i] = bool3S_64{0,0};
+        for (unsigned l=0; l<pistas; l++) fixarPista(In[i], l, extremos[W*64+l][i]);
+      }
+      return pistas;
+    }
+    uint64_t x = espalhar(Semente ^ espalhar(W));
+    for (unsigned i=0; i<Nin; i++)
+    {
+      uint64_t t = (x = espalhar(x));
+      uint64_t indef = 0;
+      if (W & 1)
+      {
+        indef = (x = espalhar(x));
+        indef &= (x = espalhar(x));
+      }
+      In[i] = bool3S_64{t & ~indef, ~t & ~indef};
+    }
+    return 64;
+  };
+
+  unsigned long long idx = percorrer(NA, NB, palavrasExtremos+palavrasAleat, NumThreads, preencher);
+  concluir(NA, NB, idx, extremos.size()+palavrasAleat*64, preencher, R);
+  // A ultima palavra de casos extremos pode estar incompleta
+  if (!R.equivalentes && idx>=palavrasExtremos*64) R.numVetores -= palavrasExtremos*64-extremos.size();
+  return true;
+}
+
+///
+/// Verificacao exaustiva
+///
+
+bool verificarEquivalenciaExaustiva(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                                    unsigned NumThreads)
+{
+  RASTRO_ESCOPO("verificar equivalencia exaustiva");
+  Netlist NA, NB;
+  R.clear();
+  R.exaustiva = true;
+  if (!compilarPar(A, B, NA, NB)) return false;
+  const unsigned Nin = NA.getNumInputs();
+  if (Nin > MAX_ENTRADAS_EXAUSTIVA)
+  {
+    std::cerr << "Circuito com mais de " << MAX_ENTRADAS_EXAUSTIVA
+              << " entradas para a verificacao exaustiva\n\n";
+    return false;
+  }
+  unsigned long long total = 1;
+  for (unsigned i=0; i<Nin; i++) total *= 3;
+
+  // O vetor de indice k tem na entrada -(i+1) o digito i de k na base 3
+  // (0: F; 1: T; 2: ?), de modo que a primeira entrada varia mais rapido
+  PreencherPalavra preencher = [&](unsigned long long W, bool3S_64* In) -> unsigned
+  {
+    std::vector<unsigned char> dig(Nin);
+    unsigned long long k = W*64;
+    for (unsigned i=0; i<Nin; i++) {dig[i] = k%3; k /= 3;}
+    for (unsigned i=0; i<Nin; i++) In[i] = bool3S_64{0,0};
+    unsigned pistas = unsigned(std::min<unsigned long long>(64, total-W*64));
+    for (unsigned l=0; l<pistas; l++)
+    {
+      uint64_t bit = uint64_t(1) << l;
+      for (unsigned i=0; i<Nin; i++)
+      {
+        if (dig[i]==0) In[i].f |= bit;
+        else if (dig[i]==1) In[i].t |= bit;
+      }
+      // Proximo vetor (incremento na base 3)
+      for (unsigned i=0; i<Nin && ++dig[i]==3; i++) dig[i] = 0;
+    }
+    return pistas;
+  };
+
+  unsigned long long idx = percorrer(NA, NB, (total+63)/64, NumThreads, preencher);
+  concluir(NA, NB, idx, total, preencher, R);
+  return true;
+}
+
+///
+/// Escolha do modo
+///
+
+// Retorna true se a verificacao exaustiva de A e B cabe no orcamento
+bool exaustivaViavel(const Circuit& A, const Circuit& B)
+{
+  const unsigned Nin = A.getNumInputs();
+  if (Nin > MAX_ENTRADAS_EXAUSTIVA) return false;
+  unsigned long long total = 1;
+  for (unsigned i=0; i<Nin; i++) total *= 3;
+  // Ateh 2^26 palavras e 2^33 portas: o produto cabe em 64 bits
+  const unsigned long long portas = (unsigned long long)A.getNumPorts() + B.getNumPorts();
+  return ((total+63)/64) * std::max(portas, 1ULL) <= MAX_TRABALHO_EXAUSTIVA;
+}
+
+// Verificacao no modo pedido
+bool verificarEquivalenciaModo(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                               ModoEquivalencia Modo)
+{
+  if (Modo==ModoEquivalencia::AUTOMATICO)
+    Modo = exaustivaViavel(A, B) ? ModoEquivalencia::EXAUSTIVO : ModoEquivalencia::VETORES;
+  if (Modo==ModoEquivalencia::EXAUSTIVO) return verificarEquivalenciaExaustiva(A, B, R);
+  return verificarEquivalencia(A, B, R);
+}
+
+// Imprime o resultado de uma verificacao
+std::ostream& operator<<(std::ostream& O, const ResultadoEquivalencia& R)
+{
+  O << R.numVetores << " vetor(es) simulado(s)" << (R.exaustiva ? " (verificacao exaustiva)" : "") << '\n';
+  if (R.equivalentes)
+  {
+    O << (R.exaustiva ? "Circuitos equivalentes\n" : "Nenhuma diferenca encontrada\n");
+    return O;
+  }
+  O << "Circuitos diferentes\nContraexemplo:";
+  for (const bool3S& x : R.contraExemplo) O << ' ' << x;
+  O << "\nSaida " << R.saidaDiferente << ": " << R.valorA << " (circuito A) x "
+    << R.valorB << " (circuito B)\n";
+  return O;
+}
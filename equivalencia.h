@@ -0,0 +1,81 @@
+#ifndef _EQUIVALENCIA_H_
+#define _EQUIVALENCIA_H_
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "bool3S.h"
+#include "circuit.h"
+
+///
+/// VERIFICACAO DE EQUIVALENCIA ENTRE DOIS CIRCUITOS
+///
+
+// Dois circuitos com o mesmo numero de entradas e de saidas sao equivalentes se, para
+// todo vetor de entradas (com valores F, T ou ?), as saidas de mesma id tem o mesmo valor
+// (F, T ou ?), ou seja, se as suas tabelas verdade (gerarTabela) sao iguais.
+//
+// Os dois circuitos sao compilados (Netlist) e simulados com os mesmos vetores, 64 por vez
+// (bool3S_64); as assinaturas das saidas (os valores nas 64 pistas) sao comparadas a cada
+// palavra, e a verificacao para no primeiro vetor em que elas diferem (contraexemplo).
+// Os flip-flops, se houver, ficam com estado UNDEF.
+
+// Numero maximo de entradas para a verificacao exaustiva (3^20 vetores)
+const unsigned MAX_ENTRADAS_EXAUSTIVA = 20;
+// Trabalho maximo da verificacao exaustiva na escolha automatica, em avaliacoes de porta
+// bool3S_64: palavras de 64 vetores (3^Nin/64) vezes as portas dos dois circuitos
+// (da ordem de 10 segundos em um nucleo)
+const unsigned long long MAX_TRABALHO_EXAUSTIVA = 1000000000ULL;
+
+// Modo da verificacao: AUTOMATICO escolhe a exaustiva quando ela cabe no orcamento de
+// trabalho (ver exaustivaViavel) e a por vetores nos outros casos
+enum class ModoEquivalencia {AUTOMATICO, EXAUSTIVO, VETORES};
+
+// Resultado de uma verificacao de equivalencia
+struct ResultadoEquivalencia {
+  bool equivalentes;
+  // Verificacao exaustiva (prova) ou por vetores (pode nao encontrar uma diferenca)
+  bool exaustiva;
+  // Numero de vetores simulados
+  unsigned long long numVetores;
+  // Contraexemplo (se nao equivalentes): vetor de entradas, id da primeira saida
+  // diferente e o valor dessa saida em cada circuito
+  std::vector<bool3S> contraExemplo;
+  int saidaDiferente;
+  bool3S valorA, valorB;
+
+  ResultadoEquivalencia();
+  void clear();
+};
+
+// Verificacao por vetores: primeiro os casos extremos (todas as entradas F, todas T,
+// todas ?, um T caminhando sobre F e um F caminhando sobre T), depois NumVetores vetores
+// aleatorios (parte deles com algumas entradas ?), divididos entre NumThreads threads
+// (0: uma por nucleo). Os vetores dependem apenas da semente, e o contraexemplo eh o
+// primeiro vetor da sequencia em que as saidas diferem.
+// Retorna false (com uma mensagem em cerr) se algum circuito for invalido ou se as
+// dimensoes forem diferentes; o resultado da verificacao fica em R
+bool verificarEquivalencia(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                           unsigned long long NumVetores=65536, uint64_t Semente=1,
+                           unsigned NumThreads=0);
+
+// Verificacao exaustiva (todos os 3^Nin vetores), dividida entre NumThreads threads
+// (0: uma por nucleo). O contraexemplo eh o primeiro vetor, na ordem da enumeracao, em
+// que as saidas diferem.
+// Retorna false (com uma mensagem em cerr) se algum circuito for invalido, se as
+// dimensoes forem diferentes ou se houver mais de MAX_ENTRADAS_EXAUSTIVA entradas
+bool verificarEquivalenciaExaustiva(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                                    unsigned NumThreads=0);
+
+// Retorna true se a verificacao exaustiva de A e B cabe no orcamento: ateh
+// MAX_ENTRADAS_EXAUSTIVA entradas e ateh MAX_TRABALHO_EXAUSTIVA avaliacoes de porta
+bool exaustivaViavel(const Circuit& A, const Circuit& B);
+
+// Verificacao no modo pedido (com os parametros padrao das funcoes acima)
+bool verificarEquivalenciaModo(const Circuit& A, const Circuit& B, ResultadoEquivalencia& R,
+                               ModoEquivalencia Modo=ModoEquivalencia::AUTOMATICO);
+
+// Imprime o resultado de uma verificacao
+std::ostream& operator<<(std::ostream& O, const ResultadoEquivalencia& R);
+
+#endif // _EQUIVALENCIA_H_
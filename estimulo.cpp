@@ -0,0 +1,50 @@
+#include <fstream>
+#include "estimulo.h"
+
+// Leh o proximo vetor de N entradas da stream I
+bool lerEstimulo(std::istream& I, unsigned N, std::vector<bool3S>& V)
+{
+  std::string lin;
+  while (std::getline(I, lin))
+  {
+    V.clear();
+    for (char c : lin)
+    {
+      if (c=='#' || c=='\t') break;
+      if (c==' ' || c=='\r') continue;
+      char u = toupper(c);
+      if (u!='F' && u!='T' && u!='?')
+      {
+        std::cerr << "Caractere invalido no estimulo: " << lin << "\n\n";
+        I.setstate(std::ios::badbit);
+        return false;
+      }
+      V.push_back(toBool3S(u));
+    }
+    if (V.empty()) continue;
+    if (V.size()!=N)
+    {
+      std::cerr << "Estimulo com " << V.size() << " valores (esperado " << N << "): " << lin << "\n\n";
+      I.setstate(std::ios::badbit);
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+// Leh todos os vetores de N entradas do arquivo arq
+bool lerEstimulos(const std::string& arq, unsigned N, std::vector<std::vector<bool3S>>& V)
+{
+  std::ifstream arquivo(arq);
+  std::vector<bool3S> prov;
+
+  V.clear();
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  while (lerEstimulo(arquivo, N, prov)) V.push_back(prov);
+  return !arquivo.bad();
+}
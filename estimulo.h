@@ -0,0 +1,31 @@
+#ifndef _ESTIMULO_H_
+#define _ESTIMULO_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bool3S.h"
+
+///
+/// LEITURA DE ARQUIVOS DE ESTIMULOS (vetores de entrada)
+///
+
+// Um arquivo de estimulos tem um vetor de entradas por linha, com os valores das
+// entradas -1, -2, ... na ordem, usando os caracteres F, T e ? (os mesmos impressos na
+// tabela verdade), separados ou nao por espacos. Exemplo para 3 entradas:
+//   F T ?
+//   TTF
+// Linhas vazias e comentarios (de '#' ateh o fim da linha) sao ignorados.
+// Tudo o que vier depois de uma tabulacao tambem eh ignorado, de modo que as linhas
+// da tabela verdade (entradas TAB saidas) podem ser usadas como estimulos.
+
+// Leh o proximo vetor de N entradas da stream I
+// Retorna false no fim do arquivo ou se a linha for invalida (nesse caso imprime
+// uma mensagem em cerr e deixa a stream com badbit)
+bool lerEstimulo(std::istream& I, unsigned N, std::vector<bool3S>& V);
+
+// Leh todos os vetores de N entradas do arquivo arq
+// Retorna true se deu tudo OK; false se deu erro
+bool lerEstimulos(const std::string& arq, unsigned N, std::vector<std::vector<bool3S>>& V);
+
+#endif // _ESTIMULO_H_
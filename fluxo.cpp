@@ -0,0 +1,205 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include "fluxo.h"
+#include "anel.h"
+#include "bytecode.h"
+#include "jit.h"
+#include "netlist.h"
+#include "estimulo.h"
+#include "rastro.h"
+
+ParamFluxo::ParamFluxo(): numTrabalhadores(0), vetoresBloco(4096), blocosTrabalhador(4), usarJIT(true) {}
+
+// Um bloco de vetores: a palavra w (vetores 64*w a 64*w+63) ocupa as posicoes
+// w*Nin a w*Nin+Nin-1 de in e w*Nout a w*Nout+Nout-1 de out
+struct BlocoFluxo {
+  // Numero de vetores no bloco
+  unsigned num;
+  // Bloco que marca o fim dos estimulos (sem vetores)
+  bool fim;
+  std::vector<bool3S_64> in;
+  std::vector<bool3S_64> out;
+};
+
+typedef AnelSPSC<BlocoFluxo*> AnelBlocos;
+
+bool simularFluxo(const Circuit& C, std::istream& I, std::ostream& O,
+                  const ParamFluxo& P, unsigned long long* NumVetores)
+{
+  RASTRO_ESCOPO("simular fluxo");
+  // O codigo gerado pelo JIT eh compartilhado pelos trabalhadores (soh leitura)
+  SimuladorJIT J;
+  if (NumVetores != nullptr) *NumVetores = 0;
+  if (!J.compilar(C))
+  {
+    std::cerr << "Circuito invalido para simulacao\n";
+    return false;
+  }
+  J.usarJIT(P.usarJIT);
+  const Netlist& N = J.getNetlist();
+  // Sem codigo nativo, o bytecode (com outra numeracao dos sinais; as entradas sao as mesmas)
+  ProgramaBytecode programa;
+  std::vector<unsigned> saidas(N.getNumOutputs());
+  if (!J.nativo()) programa.compilar(N);
+  for (unsigned j=0; j<saidas.size(); j++) saidas[j] = J.nativo() ? N.getSaida(j) : programa.getSaida(j);
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+
+  unsigned W = P.numTrabalhadores;
+  if (W==0)
+  {
+    // A leitora e a escritora tambem ocupam nucleos
+    unsigned nucleos = std::thread::hardware_concurrency();
+    W = (nucleos>2) ? nucleos-2 : 1;
+  }
+  const unsigned palavras = std::max(1u, (P.vetoresBloco+63)/64);
+  const unsigned numBlocos = W*std::max(1u, P.blocosTrabalhador);
+
+  // Blocos e filas, alocados uma unica vez
+  std::vector<BlocoFluxo> blocos(numBlocos);
+  AnelBlocos livres(numBlocos);
+  std::vector<std::unique_ptr<AnelBlocos>> entrada, saida;
+  for (BlocoFluxo& B : blocos)
+  {
+    B.in.resize(size_t(palavras)*Nin);
+    B.out.resize(size_t(palavras)*Nout);
+    livres.inserir(&B);
+  }
+  for (unsigned k=0; k<W; k++)
+  {
+    entrada.emplace_back(new AnelBlocos(numBlocos));
+    saida.emplace_back(new AnelBlocos(numBlocos));
+  }
+  std::atomic<bool> erro(false);
+
+  // Estagio 1: leitura dos estimulos
+  auto leitora = [&]()
+  {
+    RASTRO_ESCOPO("fluxo: leitura");
+    std::vector<bool3S> V;
+    unsigned long long n = 0;
+    bool acabou = false;
+    // Ultimo bloco, se ficou vazio: vira o primeiro bloco de fim (livres soh recebe
+    // blocos da escritora, o seu unico produtor)
+    BlocoFluxo* vazio = nullptr;
+    while (!acabou)
+    {
+      BlocoFluxo* B;
+      livres.esperarRetirar(B);
+      std::fill(B->in.begin(), B->in.end(), bool3S_64{0,0});
+      B->num = 0;
+      B->fim = false;
+      while (B->num < palavras*64)
+      {
+        if (!lerEstimulo(I, Nin, V))
+        {
+          if (I.bad()) erro = true;
+          acabou = true;
+          break;
+        }
+        bool3S_64* in = B->in.data() + size_t(B->num/64)*Nin;
+        uint64_t m = uint64_t(1) << (B->num%64);
+        for (unsigned i=0; i<Nin; i++)
+        {
+          if (V[i]==bool3S::TRUE) in[i].t |= m;
+          else if (V[i]==bool3S::FALSE) in[i].f |= m;
+        }
+        B->num++;
+      }
+      if (B->num>0) entrada[(n++)%W]->esperarInserir(B);
+      else vazio = B;
+    }
+    // Um bloco de fim para cada trabalhador, na sequencia
+    for (unsigned k=0; k<W; k++)
+    {
+      BlocoFluxo* B = vazio;
+      if (B==nullptr) livres.esperarRetirar(B);
+      vazio = nullptr;
+      B->num = 0;
+      B->fim = true;
+      entrada[(n++)%W]->esperarInserir(B);
+    }
+  };
+
+  // Estagio 2: simulacao
+  auto trabalhador = [&](unsigned k)
+  {
+    RASTRO_ESCOPO("fluxo: simulacao");
+    // Os sinais dos flip-flops ficam UNDEF
+    std::vector<bool3S_64> S(N.getNumSinais(), bool3S_64{0,0});
+    while (true)
+    {
+      BlocoFluxo* B;
+      entrada[k]->esperarRetirar(B);
+      if (!B->fim)
+      {
+        for (unsigned w=0; w*64<B->num; w++)
+        {
+          const bool3S_64* in = B->in.data() + size_t(w)*Nin;
+          bool3S_64* out = B->out.data() + size_t(w)*Nout;
+          for (unsigned i=0; i<Nin; i++) S[i] = in[i];
+          if (J.nativo()) J.simular(S.data());
+          else programa.simular(S.data());
+          for (unsigned j=0; j<Nout; j++) out[j] = S[saidas[j]];
+        }
+      }
+      saida[k]->esperarInserir(B);
+      if (B->fim) break;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(leitora);
+  for (unsigned k=0; k<W; k++) threads.emplace_back(trabalhador, k);
+
+  // Estagio 3: escrita, na ordem dos blocos
+  {
+    RASTRO_ESCOPO("fluxo: escrita");
+    const char simbolo[3] = {'?', 'F', 'T'};
+    std::string linhas;
+    unsigned long long n = 0, total = 0;
+    while (true)
+    {
+      BlocoFluxo* B;
+      saida[(n++)%W]->esperarRetirar(B);
+      if (B->fim)
+      {
+        livres.esperarInserir(B);
+        break;
+      }
+      linhas.resize(size_t(B->num)*2*(Nin+Nout));
+      char* c = &linhas[0];
+      for (unsigned v=0; v<B->num; v++)
+      {
+        const bool3S_64* in = B->in.data() + size_t(v/64)*Nin;
+        const bool3S_64* out = B->out.data() + size_t(v/64)*Nout;
+        for (unsigned i=0; i<Nin; i++)
+        {
+          *c++ = simbolo[int(lerPista(in[i], v%64))];
+          *c++ = (i+1<Nin) ? ' ' : '\t';
+        }
+        for (unsigned j=0; j<Nout; j++)
+        {
+          *c++ = simbolo[int(lerPista(out[j], v%64))];
+          *c++ = (j+1<Nout) ? ' ' : '\n';
+        }
+      }
+      O.write(linhas.data(), linhas.size());
+      total += B->num;
+      livres.esperarInserir(B);
+    }
+    if (NumVetores != nullptr) *NumVetores = total;
+  }
+
+  for (std::thread& T : threads) T.join();
+  O.flush();
+  if (!O)
+  {
+    std::cerr << "Erro na escrita da saida da simulacao\n";
+    return false;
+  }
+  return !erro;
+}
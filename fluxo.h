@@ -0,0 +1,46 @@
+#ifndef _FLUXO_H_
+#define _FLUXO_H_
+
+#include <iostream>
+#include "circuit.h"
+
+///
+/// SIMULACAO EM FLUXO (leitura, simulacao e escrita em paralelo)
+///
+
+// Simula um arquivo de estimulos (ver estimulo.h) de qualquer tamanho, sem carrega-lo
+// inteiro na memoria, em tres estagios ligados por filas sem travas (AnelSPSC):
+// - uma thread leitora interpreta as linhas e monta blocos de vetores, 64 por palavra;
+// - NumTrabalhadores threads simulam os blocos (bool3S_64), com o codigo nativo do JIT
+//   (ver jit.h) ou, sem ele, com o interpretador de bytecode (ver bytecode.h);
+// - a thread que chamou simularFluxo formata e escreve as linhas de saida.
+// Os blocos sao alocados uma unica vez e circulam entre os estagios: a leitora manda o
+// bloco n para o trabalhador n%NumTrabalhadores, e a escritora os recolhe na mesma
+// ordem, de modo que a saida fica na ordem dos estimulos. Depois de escritos, os blocos
+// voltam para a leitora.
+//
+// A saida tem uma linha "entradas TAB saidas" por vetor, no mesmo formato do subcomando
+// simular (que pode ser lida de novo como arquivo de estimulos). Os flip-flops, se
+// houver, ficam com estado UNDEF.
+
+struct ParamFluxo {
+  // Numero de threads de simulacao (0: os nucleos que sobram, no minimo 1)
+  unsigned numTrabalhadores;
+  // Numero de vetores por bloco (multiplo de 64)
+  unsigned vetoresBloco;
+  // Numero de blocos em circulacao por trabalhador
+  unsigned blocosTrabalhador;
+  // Simular com o codigo nativo do JIT, se suportado (false: interpretador de bytecode)
+  bool usarJIT;
+
+  ParamFluxo();
+};
+
+// Simula os estimulos da stream I e escreve o resultado na stream O
+// Retorna false (com uma mensagem em cerr) se o circuito ou algum estimulo for invalido;
+// nesse caso, os vetores anteriores ao erro jah foram escritos.
+// Se NumVetores != nullptr, recebe o numero de vetores simulados
+bool simularFluxo(const Circuit& C, std::istream& I, std::ostream& O,
+                  const ParamFluxo& P=ParamFluxo(), unsigned long long* NumVetores=nullptr);
+
+#endif // _FLUXO_H_
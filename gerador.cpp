@@ -0,0 +1,241 @@
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include "gerador.h"
+#include "rastro.h"
+
+// As siglas dos tipos de porta, na mesma ordem de ParamGerador::pesosTipo
+static const char* siglaTipo[NUM_TIPOS_GERADOR] = {"NT","AN","NA","OR","NO","XO","NX"};
+
+///
+/// Funcoes auxiliares de sorteio
+///
+
+// As distribuicoes da STL (uniform_int_distribution etc.) dependem da implementacao
+// da biblioteca. Para que a mesma semente gere o mesmo circuito em qualquer plataforma,
+// os sorteios sao feitos diretamente a partir da sequencia do mt19937_64, que eh padronizada.
+
+// Sorteia um inteiro entre 0 e N-1
+static uint64_t sortearInt(std::mt19937_64& G, uint64_t N)
+{
+  return G() % N;
+}
+
+// Sorteia um real entre 0 e 1 (exclusive)
+static double sortearReal(std::mt19937_64& G)
+{
+  return (G() >> 11) * (1.0/9007199254740992.0);
+}
+
+// Sorteia um indice de acordo com os pesos relativos do vetor Pesos
+static unsigned sortearPeso(std::mt19937_64& G, const double* Pesos, unsigned N)
+{
+  double total = 0.0;
+  for (unsigned i=0; i<N; i++) total += Pesos[i];
+  double r = sortearReal(G)*total;
+  for (unsigned i=0; i<N; i++)
+  {
+    if (r < Pesos[i]) return i;
+    r -= Pesos[i];
+  }
+  // Arredondamento: retorna o ultimo indice com peso nao nulo
+  for (unsigned i=N; i>0; i--) if (Pesos[i-1] > 0.0) return i-1;
+  return 0;
+}
+
+///
+/// ParamGerador
+///
+
+// Construtor com valores padrao (um circuito pequeno e acilico)
+ParamGerador::ParamGerador():
+  Nin(8), Nout(4), Nportas(100), profundidade(10),
+  fanInMin(2), pesosFanIn({0.6, 0.25, 0.15}),
+  fracForaOrdem(0.0), fracRealimentacao(0.0), semente(1)
+{
+  // Mistura tipica: NAND e NOR predominam, seguidos de NOT, AND e OR
+  const double pesos[NUM_TIPOS_GERADOR] = {0.15, 0.15, 0.25, 0.1, 0.2, 0.1, 0.05};
+  for (unsigned i=0; i<NUM_TIPOS_GERADOR; i++) pesosTipo[i] = pesos[i];
+}
+
+// Retorna true se os parametros sao consistentes
+bool ParamGerador::valid() const
+{
+  if (Nin==0 || Nout==0 || Nportas==0) return false;
+  if (profundidade==0 || profundidade>Nportas) return false;
+  if (fanInMin<2 || pesosFanIn.empty()) return false;
+  double total = 0.0;
+  for (double p : pesosFanIn) {if (p<0.0) return false; total += p;}
+  if (total<=0.0) return false;
+  total = 0.0;
+  for (unsigned i=0; i<NUM_TIPOS_GERADOR; i++) {if (pesosTipo[i]<0.0) return false; total += pesosTipo[i];}
+  if (total<=0.0) return false;
+  if (fracForaOrdem<0.0 || fracForaOrdem>1.0) return false;
+  if (fracRealimentacao<0.0 || fracRealimentacao>1.0) return false;
+  return true;
+}
+
+///
+/// GERACAO
+///
+
+// Gera o circuito descrito por P e escreve na ostream O
+// As portas sao inicialmente geradas em ordem topologica (a porta k esta no nivel
+// 1+k*profundidade/Nportas e sua primeira entrada vem do nivel anterior, o que garante
+// a profundidade pedida). Em seguida:
+// - uma fracao das portas recebe uma entrada vinda do seu proprio cone de saida (laco);
+// - uma fracao das portas tem a id trocada com outra, ficando fora da ordem topologica.
+bool gerarCircuito(const ParamGerador& P, std::ostream& O)
+{
+  if (!P.valid())
+  {
+    std::cerr << "Parametros invalidos para a geracao do circuito\n";
+    return false;
+  }
+
+  RASTRO_ESCOPO("gerarCircuito");
+  std::mt19937_64 G(P.semente);
+  const unsigned NP = P.Nportas;
+  const int NI = int(P.Nin);
+
+  // Inicio (indice da primeira porta) de cada nivel; inicio[L] para L de 1 a profundidade+1
+  std::vector<unsigned> inicio(P.profundidade+2, NP);
+  for (unsigned k=NP; k>0; k--) inicio[1+((unsigned long long)(k-1)*P.profundidade)/NP] = k-1;
+
+  // Portas em ordem topologica: tipo e ids das entradas (porta k tem id provisoria k+1)
+  std::vector<unsigned char> tipo(NP);
+  std::vector<unsigned> inicioEntr(NP+1, 0);
+  std::vector<int> entr;
+  entr.reserve(size_t(NP)*(P.fanInMin+1));
+
+  unsigned proxEntrada = 0;
+  for (unsigned L=1; L<=P.profundidade; L++)
+  {
+    for (unsigned k=inicio[L]; k<inicio[L+1]; k++)
+    {
+      tipo[k] = sortearPeso(G, P.pesosTipo, NUM_TIPOS_GERADOR);
+      unsigned NIn = 1;
+      if (tipo[k]!=0) NIn = P.fanInMin + sortearPeso(G, P.pesosFanIn.data(), P.pesosFanIn.size());
+
+      inicioEntr[k] = entr.size();
+      // A primeira entrada vem do nivel anterior (ou das entradas do circuito, no nivel 1,
+      // percorridas circularmente para que todas sejam usadas)
+      if (L==1) entr.push_back(-int(1 + (proxEntrada++)%NI));
+      else entr.push_back(1 + int(inicio[L-1] + sortearInt(G, inicio[L]-inicio[L-1])));
+      // As demais vem preferencialmente do nivel anterior, ou de qualquer sinal anterior
+      for (unsigned j=1; j<NIn; j++)
+      {
+        int id = 0;
+        for (unsigned tent=0; tent<4; tent++)
+        {
+          if (L==1 || sortearReal(G)<0.5)
+          {
+            if (L==1) id = -int(1 + sortearInt(G, NI));
+            else id = 1 + int(inicio[L-1] + sortearInt(G, inicio[L]-inicio[L-1]));
+          }
+          else
+          {
+            uint64_t r = sortearInt(G, NI + inicio[L]);
+            id = (r < uint64_t(NI)) ? -int(1+r) : int(r-NI+1);
+          }
+          // Evita (se possivel) entradas repetidas na mesma porta
+          if (std::find(entr.begin()+inicioEntr[k], entr.end(), id) == entr.end()) break;
+        }
+        entr.push_back(id);
+      }
+    }
+  }
+  inicioEntr[NP] = entr.size();
+
+  // Fanout de cada porta (apenas portas alimentadas por portas)
+  std::vector<std::vector<unsigned>> fanout(NP);
+  for (unsigned k=0; k<NP; k++)
+  {
+    for (unsigned j=inicioEntr[k]; j<inicioEntr[k+1]; j++)
+    {
+      if (entr[j]>0) fanout[entr[j]-1].push_back(k);
+    }
+  }
+
+  // Realimentacao: a porta k passa a receber, em uma das entradas, a saida de uma porta
+  // alcancada a partir de k por um caminho de 1 a 3 portas no seu cone de saida
+  if (P.fracRealimentacao>0.0)
+  {
+    for (unsigned k=0; k<NP; k++)
+    {
+      if (sortearReal(G) >= P.fracRealimentacao) continue;
+      unsigned h = k;
+      unsigned passos = 1 + sortearInt(G, 3);
+      for (unsigned s=0; s<passos && !fanout[h].empty(); s++)
+      {
+        h = fanout[h][sortearInt(G, fanout[h].size())];
+      }
+      if (h==k) continue;
+      unsigned NIn = inicioEntr[k+1]-inicioEntr[k];
+      unsigned j = inicioEntr[k] + (NIn>1 ? 1+sortearInt(G, NIn-1) : 0);
+      int antigo = entr[j];
+      if (antigo>0)
+      {
+        std::vector<unsigned>& F = fanout[antigo-1];
+        F.erase(std::find(F.begin(), F.end(), k));
+      }
+      entr[j] = int(h+1);
+      fanout[h].push_back(k);
+    }
+  }
+
+  // Saidas: preferencialmente as portas sem fanout, das mais profundas para as mais rasas
+  std::vector<int> saidas;
+  saidas.reserve(P.Nout);
+  for (unsigned k=NP; k>0 && saidas.size()<P.Nout; k--)
+  {
+    if (fanout[k-1].empty()) saidas.push_back(int(k));
+  }
+  while (saidas.size()<P.Nout) saidas.push_back(1 + int(sortearInt(G, NP)));
+
+  // Fora de ordem: troca a posicao (id) de pares de portas
+  // pos[k] eh a id final (menos 1) da porta k; ordem eh a inversa
+  std::vector<unsigned> pos(NP);
+  for (unsigned k=0; k<NP; k++) pos[k] = k;
+  unsigned long long trocas = (unsigned long long)(P.fracForaOrdem*NP/2.0 + 0.5);
+  for (unsigned long long t=0; t<trocas; t++)
+  {
+    std::swap(pos[sortearInt(G, NP)], pos[sortearInt(G, NP)]);
+  }
+  std::vector<unsigned> ordem(NP);
+  for (unsigned k=0; k<NP; k++) ordem[pos[k]] = k;
+
+  // Impressao no formato lido por Circuit::ler
+  O << "CIRCUITO: " << P.Nin << ' ' << P.Nout << ' ' << NP;
+  O << "\nPORTAS:";
+  for (unsigned i=0; i<NP; i++)
+  {
+    unsigned k = ordem[i];
+    O << '\n' << i+1 << ") " << siglaTipo[tipo[k]] << ' ' << inicioEntr[k+1]-inicioEntr[k] << ':';
+    for (unsigned j=inicioEntr[k]; j<inicioEntr[k+1]; j++)
+    {
+      int id = entr[j];
+      O << ' ' << (id>0 ? int(pos[id-1]+1) : id);
+    }
+  }
+  O << "\nSAIDAS:";
+  for (unsigned i=0; i<P.Nout; i++)
+  {
+    O << '\n' << i+1 << ") " << int(pos[saidas[i]-1]+1);
+  }
+  O << '\n';
+  return bool(O);
+}
+
+// Gera o circuito descrito por P e salva no arquivo arq
+// Retorna true se deu tudo OK; false se deu erro
+bool gerarCircuito(const ParamGerador& P, const std::string& arq)
+{
+  std::ofstream arquivo(arq);
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  return gerarCircuito(P, arquivo);
+}
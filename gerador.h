@@ -0,0 +1,57 @@
+#ifndef _GERADOR_H_
+#define _GERADOR_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+///
+/// GERADOR DE CIRCUITOS SINTETICOS
+///
+
+// Gera netlists validas no formato de texto do projeto (CIRCUITO: / PORTAS: / SAIDAS:),
+// que podem ser lidas por Circuit::ler, para testes de escala e de estresse.
+// A geracao eh deterministica: os mesmos parametros (incluindo a semente) geram
+// sempre o mesmo arquivo, em qualquer plataforma.
+
+// Ordem dos tipos de porta nos pesos de ParamGerador::pesosTipo
+// NT, AN, NA, OR, NO, XO, NX
+const unsigned NUM_TIPOS_GERADOR = 7;
+
+struct ParamGerador {
+  // Dimensoes do circuito
+  unsigned Nin;
+  unsigned Nout;
+  unsigned Nportas;
+  // Numero de niveis logicos (profundidade) da parte combinacional; 1 <= profundidade <= Nportas
+  unsigned profundidade;
+  // Distribuicao do numero de entradas das portas (exceto NOT, que sempre tem 1)
+  // pesosFanIn[k] eh o peso relativo de uma porta com fanInMin+k entradas
+  unsigned fanInMin;
+  std::vector<double> pesosFanIn;
+  // Pesos relativos de cada tipo de porta (NT, AN, NA, OR, NO, XO, NX)
+  double pesosTipo[NUM_TIPOS_GERADOR];
+  // Fracao (0 a 1) das portas que sao listadas fora da ordem topologica
+  double fracForaOrdem;
+  // Fracao (0 a 1) das portas que recebem uma entrada realimentada (formando um laco)
+  double fracRealimentacao;
+  // Semente do gerador pseudoaleatorio
+  uint64_t semente;
+
+  // Construtor com valores padrao (um circuito pequeno e acilico)
+  ParamGerador();
+
+  // Retorna true se os parametros sao consistentes
+  bool valid() const;
+};
+
+// Gera o circuito descrito por P e escreve na ostream O
+// Retorna true se deu tudo OK; false se os parametros forem invalidos
+bool gerarCircuito(const ParamGerador& P, std::ostream& O);
+
+// Gera o circuito descrito por P e salva no arquivo arq
+// Retorna true se deu tudo OK; false se deu erro
+bool gerarCircuito(const ParamGerador& P, const std::string& arq);
+
+#endif // _GERADOR_H_
@@ -0,0 +1,510 @@
+#include <fstream>
+#include <climits>
+#include <algorithm>
+#include "hierarquia.h"
+#include "estimulo.h"
+#include "rastro.h"
+
+///
+/// Funcoes auxiliares
+///
+
+// Imprime uma mensagem de erro (com o nome do subcircuito, se houver) e retorna false
+static bool erroHier(const std::string& Nome, const std::string& Msg)
+{
+  std::cerr << "Circuito hierarquico";
+  if (!Nome.empty()) std::cerr << " (subcircuito " << Nome << ")";
+  std::cerr << ": " << Msg << "\n\n";
+  return false;
+}
+
+// Confere a palavra chave Chave seguida de ':' (junto ou separado), cuja primeira
+// parte (Prov) jah foi lida
+static bool lerChave(std::istream& I, const std::string& Prov, const std::string& Chave)
+{
+  if (Prov == Chave+":") return true;
+  if (Prov != Chave) return false;
+  std::string sep;
+  I >> sep;
+  return sep == ":";
+}
+
+///
+/// CLASSE CircuitoHierarquico
+///
+
+/// ***********************
+/// Inicializacao e E/S
+/// ***********************
+
+void CircuitoHierarquico::clear()
+{
+  defs.clear();
+  nomes.clear();
+  pilha.clear();
+}
+
+// Leh o corpo (CIRCUITO: ... PORTAS: ... SAIDAS: ...) de uma definicao
+bool CircuitoHierarquico::lerCorpo(std::istream& I, const std::string& Primeiro, Definicao& D)
+{
+  std::string prov;
+  unsigned NIn, NOut, NIds;
+
+  if (!lerChave(I, Primeiro, "CIRCUITO")) return erroHier(D.nome, "palavra chave CIRCUITO nao encontrada");
+  if (!(I >> NIn >> NOut >> NIds) || NIn==0 || NOut==0 || NIds==0)
+  {
+    return erroHier(D.nome, "numero de entradas | saidas | portas invalido");
+  }
+  I >> prov;
+  if (!lerChave(I, prov, "PORTAS")) return erroHier(D.nome, "palavra chave PORTAS nao encontrada");
+  D.Nin = NIn;
+  D.Nsinais = NIn+NIds;
+
+  // Converte uma id de origem para o indice do sinal local (false se invalida)
+  auto local = [&](int Id, unsigned& S) -> bool
+  {
+    if (Id<0 && unsigned(-Id)<=NIn) S = unsigned(-Id)-1;
+    else if (Id>0 && unsigned(Id)<=NIds) S = NIn+unsigned(Id)-1;
+    else return false;
+    return true;
+  };
+
+  unsigned id = 1;
+  while (id <= NIds)
+  {
+    unsigned k, n;
+    char c;
+    Elemento E;
+    if (!(I >> k) || k != id) return erroHier(D.nome, "id de porta esperada nao encontrada: " + std::to_string(id));
+    I >> prov;
+    if (prov != ")") return erroHier(D.nome, "caractere ')' nao encontrado");
+    I >> prov;
+    if (!prov.empty() && prov[0]=='@')
+    {
+      auto it = nomes.find(prov.substr(1));
+      if (it == nomes.end()) return erroHier(D.nome, "subcircuito nao definido: " + prov.substr(1));
+      E.def = int(it->second);
+      E.tipo = TipoPorta::AN;
+      E.numSaidas = defs[it->second].saidas.size();
+    }
+    else
+    {
+      if (!tipoPorta(prov, E.tipo)) return erroHier(D.nome, "tipo de porta invalido: " + prov);
+      E.def = -1;
+      E.numSaidas = 1;
+    }
+    if (!(I >> n >> c) || c != ':') return erroHier(D.nome, "numero de entradas da porta " + std::to_string(id) + " invalido");
+    bool nOK;
+    if (E.def >= 0) nOK = (n == defs[E.def].Nin);
+    else if (E.tipo==TipoPorta::NT || E.tipo==TipoPorta::FF) nOK = (n == 1);
+    else nOK = (n >= 2);
+    if (!nOK) return erroHier(D.nome, "numero de entradas da porta " + std::to_string(id) + " invalido");
+    if (id-1+E.numSaidas > NIds) return erroHier(D.nome, "instancia " + std::to_string(id) + " ultrapassa o numero de portas");
+
+    E.inicioEntr = D.entr.size();
+    E.numEntr = n;
+    E.saida = NIn+id-1;
+    for (unsigned j=0; j<n; j++)
+    {
+      int orig;
+      unsigned s;
+      if (!(I >> orig) || !local(orig, s)) return erroHier(D.nome, "sinal de origem invalido na porta " + std::to_string(id));
+      D.entr.push_back(s);
+    }
+    D.elem.push_back(E);
+    id += E.numSaidas;
+  }
+
+  I >> prov;
+  if (!lerChave(I, prov, "SAIDAS")) return erroHier(D.nome, "palavra chave SAIDAS nao encontrada");
+  for (unsigned j=1; j<=NOut; j++)
+  {
+    unsigned k, s;
+    int orig;
+    if (!(I >> k) || k != j) return erroHier(D.nome, "id de saida esperada nao encontrada: " + std::to_string(j));
+    I >> prov;
+    if (prov != ")") return erroHier(D.nome, "caractere ')' nao encontrado");
+    if (!(I >> orig) || !local(orig, s)) return erroHier(D.nome, "sinal de origem invalido na saida " + std::to_string(j));
+    D.saidas.push_back(s);
+  }
+  return true;
+}
+
+// Calcula a ordem de avaliacao e os dados de achatamento de uma definicao
+void CircuitoHierarquico::compilar(Definicao& D)
+{
+  const unsigned NE = D.elem.size();
+
+  // Elemento que define cada sinal local (~0u para as entradas)
+  std::vector<unsigned> origem(D.Nsinais, ~0u);
+  for (unsigned e=0; e<NE; e++)
+  {
+    for (unsigned k=0; k<D.elem[e].numSaidas; k++) origem[D.elem[e].saida+k] = e;
+  }
+
+  // Levelizacao (algoritmo de Kahn) dos elementos; os flip-flops sao fontes de sinal
+  std::vector<unsigned> falta(NE, 0);
+  std::vector<std::vector<unsigned>> dependentes(NE);
+  for (unsigned e=0; e<NE; e++)
+  {
+    const Elemento& E = D.elem[e];
+    if (E.def<0 && E.tipo==TipoPorta::FF) continue;
+    for (unsigned j=0; j<E.numEntr; j++)
+    {
+      unsigned o = origem[D.entr[E.inicioEntr+j]];
+      if (o == ~0u) continue;
+      falta[e]++;
+      dependentes[o].push_back(e);
+    }
+  }
+  D.ordem.clear();
+  for (unsigned e=0; e<NE; e++) if (falta[e]==0) D.ordem.push_back(e);
+  for (unsigned i=0; i<D.ordem.size(); i++)
+  {
+    for (unsigned q : dependentes[D.ordem[i]]) if (--falta[q]==0) D.ordem.push_back(q);
+  }
+  D.inicioLaco = D.ordem.size();
+  for (unsigned e=0; e<NE; e++) if (falta[e]!=0) D.ordem.push_back(e);
+
+  // Pilha de trabalho e posicoes no circuito achatado
+  D.tamPilha = D.Nsinais;
+  D.numPortas = 0;
+  D.deslocamento.resize(NE);
+  for (unsigned e=0; e<NE; e++)
+  {
+    const Elemento& E = D.elem[e];
+    D.deslocamento[e] = D.numPortas;
+    if (E.def<0) D.numPortas++;
+    else
+    {
+      const Definicao& F = defs[E.def];
+      D.tamPilha = std::max(D.tamPilha, D.Nsinais+F.tamPilha);
+      D.numPortas += F.numPortas+F.numBuffers;
+    }
+  }
+  D.numBuffers = 0;
+  D.posSaida.resize(D.saidas.size());
+  for (unsigned j=0; j<D.saidas.size(); j++)
+  {
+    if (D.saidas[j] < D.Nin) D.posSaida[j] = D.numPortas + ++D.numBuffers;
+    else D.posSaida[j] = posLocal(D, D.saidas[j]);
+  }
+}
+
+// Leh um circuito hierarquico da stream I
+bool CircuitoHierarquico::ler(std::istream& I)
+{
+  RASTRO_ESCOPO("ler hierarquico");
+  std::string prov;
+  clear();
+  while (I >> prov)
+  {
+    Definicao D;
+    if (prov == "SUBCIRCUITO")
+    {
+      I >> D.nome;
+      if (!D.nome.empty() && D.nome.back()==':') D.nome.pop_back();
+      else
+      {
+        I >> prov;
+        if (prov != ":") {clear(); return erroHier(D.nome, "separador ':' nao encontrado");}
+      }
+      if (D.nome.empty() || nomes.count(D.nome)>0) {clear(); return erroHier(D.nome, "nome de subcircuito invalido ou repetido");}
+      I >> prov;
+      if (!lerCorpo(I, prov, D)) {clear(); return false;}
+      I >> prov;
+      if (prov != "FIM") {clear(); return erroHier(D.nome, "palavra chave FIM nao encontrada");}
+      compilar(D);
+      nomes[D.nome] = defs.size();
+      defs.push_back(std::move(D));
+    }
+    else
+    {
+      // Circuito principal
+      if (!lerCorpo(I, prov, D)) {clear(); return false;}
+      compilar(D);
+      defs.push_back(std::move(D));
+      pilha.assign(defs.back().tamPilha, bool3S_64{0,0});
+      return true;
+    }
+  }
+  clear();
+  return erroHier("", "circuito principal nao encontrado");
+}
+
+bool CircuitoHierarquico::ler(const std::string& arq)
+{
+  std::ifstream arquivo(arq);
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  return ler(arquivo);
+}
+
+// Imprime o corpo de uma definicao
+void CircuitoHierarquico::imprimirCorpo(std::ostream& O, const Definicao& D) const
+{
+  auto id = [&](unsigned S) {return S<D.Nin ? -int(S)-1 : int(S-D.Nin)+1;};
+  O << "CIRCUITO: " << D.Nin << ' ' << D.saidas.size() << ' ' << D.Nsinais-D.Nin;
+  O << "\nPORTAS:";
+  for (const Elemento& E : D.elem)
+  {
+    O << "\n" << id(E.saida) << ") ";
+    if (E.def>=0) O << '@' << defs[E.def].nome;
+    else O << siglaPorta(E.tipo);
+    O << ' ' << E.numEntr << ':';
+    for (unsigned j=0; j<E.numEntr; j++) O << ' ' << id(D.entr[E.inicioEntr+j]);
+  }
+  O << "\nSAIDAS:";
+  for (unsigned j=0; j<D.saidas.size(); j++) O << "\n" << j+1 << ") " << id(D.saidas[j]);
+}
+
+// Imprime o circuito no mesmo formato da leitura
+std::ostream& CircuitoHierarquico::imprimir(std::ostream& O) const
+{
+  for (unsigned d=0; d+1<defs.size(); d++)
+  {
+    O << "SUBCIRCUITO " << defs[d].nome << ":\n";
+    imprimirCorpo(O, defs[d]);
+    O << "\nFIM\n";
+  }
+  if (!defs.empty()) imprimirCorpo(O, defs.back());
+  return O;
+}
+
+/// ***********************
+/// Achatamento
+/// ***********************
+
+// Posicao no circuito achatado do sinal local S (nao entrada) da definicao D
+unsigned long long CircuitoHierarquico::posLocal(const Definicao& D, unsigned S) const
+{
+  // Os elementos estao em ordem crescente do primeiro sinal definido
+  auto it = std::upper_bound(D.elem.begin(), D.elem.end(), S,
+                             [](unsigned X, const Elemento& E) {return X < E.saida;});
+  unsigned e = unsigned(it-D.elem.begin())-1;
+  const Elemento& E = D.elem[e];
+  if (E.def<0) return D.deslocamento[e]+1;
+  return D.deslocamento[e]+defs[E.def].posSaida[S-E.saida];
+}
+
+// Gera no circuito achatado as portas de uma instancia da definicao D, a partir da
+// porta de id Base+1
+// As saidas da instancia que sao ligadas diretamente a entradas viram buffers
+// (AN 2: x x), pois no formato achatado uma id de porta nao pode ser um apelido
+void CircuitoHierarquico::expandir(unsigned D, unsigned long long Base,
+                                   const std::vector<int>& IdsEntrada, Circuit& C) const
+{
+  const Definicao& Def = defs[D];
+  auto achatado = [&](unsigned S) {return S<Def.Nin ? IdsEntrada[S] : int(Base+posLocal(Def, S));};
+  std::vector<int> in;
+  for (unsigned e=0; e<Def.elem.size(); e++)
+  {
+    const Elemento& E = Def.elem[e];
+    const unsigned* ent = Def.entr.data()+E.inicioEntr;
+    if (E.def<0)
+    {
+      int id = int(Base+Def.deslocamento[e]+1);
+      C.setPort(id, siglaPorta(E.tipo), E.numEntr);
+      for (unsigned j=0; j<E.numEntr; j++) C.setId_inPort(id, j, achatado(ent[j]));
+      continue;
+    }
+    const Definicao& F = defs[E.def];
+    in.resize(E.numEntr);
+    for (unsigned j=0; j<E.numEntr; j++) in[j] = achatado(ent[j]);
+    expandir(E.def, Base+Def.deslocamento[e], in, C);
+    int buf = int(Base+Def.deslocamento[e]+F.numPortas);
+    for (unsigned s : F.saidas)
+    {
+      if (s >= F.Nin) continue;
+      buf++;
+      C.setPort(buf, "AN", 2);
+      C.setId_inPort(buf, 0, in[s]);
+      C.setId_inPort(buf, 1, in[s]);
+    }
+  }
+}
+
+// Gera o circuito achatado equivalente (sem subcircuitos)
+bool CircuitoHierarquico::achatar(Circuit& C) const
+{
+  RASTRO_ESCOPO("achatar");
+  C.clear();
+  if (defs.empty()) return false;
+  const Definicao& Topo = defs.back();
+  if (Topo.numPortas==0 || Topo.numPortas>(unsigned long long)INT_MAX)
+  {
+    return erroHier("", "circuito achatado vazio ou grande demais");
+  }
+  C.resize(Topo.Nin, Topo.saidas.size(), unsigned(Topo.numPortas));
+  std::vector<int> ids(Topo.Nin);
+  for (unsigned i=0; i<Topo.Nin; i++) ids[i] = -int(i)-1;
+  expandir(defs.size()-1, 0, ids, C);
+  for (unsigned j=0; j<Topo.saidas.size(); j++)
+  {
+    unsigned s = Topo.saidas[j];
+    C.setIdOutput(j+1, s<Topo.Nin ? ids[s] : int(posLocal(Topo, s)));
+  }
+  return C.valid();
+}
+
+/// ***********************
+/// Funcoes de consulta
+/// ***********************
+
+// Numero de elementos (portas e instancias) armazenados em todas as definicoes
+unsigned long long CircuitoHierarquico::getNumElementos() const
+{
+  unsigned long long N = 0;
+  for (const Definicao& D : defs) N += D.elem.size();
+  return N;
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+// Avalia uma definicao com os sinais locais em L (entradas jah fixadas)
+// Os sinais locais das instancias ficam na pilha, logo depois dos de L
+void CircuitoHierarquico::avaliar(unsigned D, bool3S_64* L) const
+{
+  const Definicao& Def = defs[D];
+  bool3S_64* filho = L+Def.Nsinais;
+
+  // Avalia um elemento; retorna true se alguma das suas saidas mudou
+  auto avaliarElem = [&](const Elemento& E) -> bool
+  {
+    const unsigned* ent = Def.entr.data()+E.inicioEntr;
+    if (E.def<0)
+    {
+      // Um flip-flop, cujo estado nao eh armazenado, vale UNDEF
+      bool3S_64 v = (E.tipo==TipoPorta::FF) ? bool3S_64{0,0} : avaliarPorta(E.tipo, ent, E.numEntr, L);
+      if (v==L[E.saida]) return false;
+      L[E.saida] = v;
+      return true;
+    }
+    const Definicao& F = defs[E.def];
+    for (unsigned j=0; j<E.numEntr; j++) filho[j] = L[ent[j]];
+    avaliar(E.def, filho);
+    bool mudou = false;
+    for (unsigned k=0; k<E.numSaidas; k++)
+    {
+      const bool3S_64& v = filho[F.saidas[k]];
+      if (v!=L[E.saida+k])
+      {
+        L[E.saida+k] = v;
+        mudou = true;
+      }
+    }
+    return mudou;
+  };
+
+  // Parte sem lacos: uma unica passada
+  for (unsigned i=0; i<Def.inicioLaco; i++) avaliarElem(Def.elem[Def.ordem[i]]);
+  if (Def.inicioLaco==Def.ordem.size()) return;
+
+  // Parte com lacos: parte de UNDEF e reavalia ateh o ponto fixo
+  for (unsigned i=Def.inicioLaco; i<Def.ordem.size(); i++)
+  {
+    const Elemento& E = Def.elem[Def.ordem[i]];
+    for (unsigned k=0; k<E.numSaidas; k++) L[E.saida+k] = bool3S_64{0,0};
+  }
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned i=Def.inicioLaco; i<Def.ordem.size(); i++)
+    {
+      if (avaliarElem(Def.elem[Def.ordem[i]])) mudou = true;
+    }
+  } while (mudou);
+}
+
+// Simula o circuito para 64 vetores de entrada ao mesmo tempo
+void CircuitoHierarquico::simular(const bool3S_64* In, bool3S_64* Out)
+{
+  const Definicao& Topo = defs.back();
+  for (unsigned i=0; i<Topo.Nin; i++) pilha[i] = In[i];
+  avaliar(defs.size()-1, pilha.data());
+  for (unsigned j=0; j<Topo.saidas.size(); j++) Out[j] = pilha[Topo.saidas[j]];
+}
+
+// Simula o circuito para um unico vetor de entradas
+bool CircuitoHierarquico::simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ)
+{
+  if (defs.empty() || in_circ.size()!=getNumInputs()) return false;
+  std::vector<bool3S_64> in(in_circ.size()), out(getNumOutputs());
+  for (unsigned i=0; i<in_circ.size(); i++) in[i] = difundir(in_circ[i]);
+  simular(in.data(), out.data());
+  out_circ.resize(out.size());
+  for (unsigned j=0; j<out.size(); j++) out_circ[j] = lerPista(out[j], 0);
+  return true;
+}
+
+// Simula os estimulos da stream I, 64 vetores por vez
+bool CircuitoHierarquico::simularEstimulos(std::istream& I, std::ostream& O, unsigned long long* NumVetores)
+{
+  RASTRO_ESCOPO("simular estimulos (hierarquico)");
+  if (NumVetores != nullptr) *NumVetores = 0;
+  if (defs.empty())
+  {
+    std::cerr << "Circuito hierarquico vazio\n";
+    return false;
+  }
+  const unsigned Nin = getNumInputs();
+  const unsigned Nout = getNumOutputs();
+  std::vector<bool3S_64> in(Nin), out(Nout);
+  std::vector<bool3S> V;
+  std::string linha;
+  unsigned long long total = 0;
+  bool fim = false;
+  while (!fim)
+  {
+    unsigned n = 0;
+    for (; n<64; n++)
+    {
+      if (!lerEstimulo(I, Nin, V))
+      {
+        fim = true;
+        break;
+      }
+      for (unsigned i=0; i<Nin; i++) fixarPista(in[i], n, V[i]);
+    }
+    if (n==0) break;
+    simular(in.data(), out.data());
+    for (unsigned v=0; v<n; v++)
+    {
+      linha.clear();
+      for (unsigned i=0; i<Nin; i++)
+      {
+        linha += toChar(lerPista(in[i], v));
+        linha += (i+1<Nin) ? ' ' : '\t';
+      }
+      for (unsigned j=0; j<Nout; j++)
+      {
+        linha += toChar(lerPista(out[j], v));
+        linha += (j+1<Nout) ? ' ' : '\n';
+      }
+      O << linha;
+    }
+    total += n;
+  }
+  if (NumVetores != nullptr) *NumVetores = total;
+  O.flush();
+  if (!O)
+  {
+    std::cerr << "Erro na escrita da saida da simulacao\n";
+    return false;
+  }
+  return !I.bad();
+}
+
+// Retorna true se o arquivo arq contem um circuito hierarquico
+bool arquivoHierarquico(const std::string& arq)
+{
+  std::ifstream arquivo(arq);
+  std::string palavra;
+  return arquivo.is_open() && (arquivo >> palavra) && palavra=="SUBCIRCUITO";
+}
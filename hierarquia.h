@@ -0,0 +1,164 @@
+#ifndef _HIERARQUIA_H_
+#define _HIERARQUIA_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// CIRCUITOS HIERARQUICOS (subcircuitos definidos uma vez e instanciados)
+///
+
+// Formato: zero ou mais definicoes de subcircuito, seguidas do circuito principal.
+// Cada definicao eh um circuito no formato normal entre "SUBCIRCUITO NOME:" e "FIM":
+//
+//   SUBCIRCUITO SOMADOR:
+//   CIRCUITO: 3 2 5
+//   PORTAS:
+//   1) XO 2: -1 -2
+//   2) XO 2: 1 -3
+//   3) AN 2: -1 -2
+//   4) AN 2: 1 -3
+//   5) OR 2: 3 4
+//   SAIDAS:
+//   1) 2
+//   2) 5
+//   FIM
+//   CIRCUITO: 4 3 4
+//   PORTAS:
+//   1) @SOMADOR 3: -1 -2 -3
+//   3) @SOMADOR 3: -4 2 -3
+//   SAIDAS:
+//   1) 1
+//   2) 3
+//   3) 4
+//
+// Uma instancia ("@NOME", seguida das ligacoes das entradas) define tantas ids consecutivas
+// quantas sao as saidas do subcircuito: no exemplo, a instancia 1) define as ids 1 e 2 e a
+// instancia 3) define as ids 3 e 4. O numero de portas do cabecalho eh o numero de ids.
+// Uma definicao pode instanciar as definicoes anteriores a ela (nao ha recursao).
+//
+// Cada definicao eh compilada uma unica vez (levelizacao dos seus elementos). A simulacao
+// avalia cada instancia com os sinais locais da definicao em uma pilha de trabalho, de modo
+// que a memoria depende apenas das definicoes distintas e da profundidade da hierarquia, e
+// nao do numero de portas do circuito achatado. Como em Circuit::simular, o resultado eh o
+// menor ponto fixo da logica de 3 estados (os lacos de cada definicao sao iterados a partir
+// de UNDEF). Os flip-flops sao avaliados com estado UNDEF; para simular ciclos de clock, o
+// circuito deve ser achatado.
+class CircuitoHierarquico {
+private:
+  // Uma porta primitiva ou uma instancia de subcircuito
+  struct Elemento {
+    int def;               // -1: porta primitiva; >=0: definicao instanciada
+    TipoPorta tipo;
+    unsigned inicioEntr;   // entradas: entr[inicioEntr] ateh entr[inicioEntr+numEntr-1]
+    unsigned numEntr;
+    unsigned saida;        // primeiro sinal local definido pelo elemento
+    unsigned numSaidas;
+  };
+
+  // Sinais locais de uma definicao: de 0 a Nin-1 as entradas; Nin+id-1 para a id id
+  struct Definicao {
+    std::string nome;
+    unsigned Nin;
+    unsigned Nsinais;
+    std::vector<Elemento> elem;
+    std::vector<unsigned> entr;
+    std::vector<unsigned> saidas;
+    // Ordem de avaliacao dos elementos; a partir de ordem[inicioLaco] dependem de lacos
+    std::vector<unsigned> ordem;
+    unsigned inicioLaco;
+    // Sinais locais desta definicao mais os das instancias aninhadas
+    unsigned tamPilha;
+    // Achatamento: portas do corpo, posicao do primeiro sinal de cada elemento e posicao
+    // de cada saida (relativas ao inicio da instancia; as saidas que sao entradas viram
+    // buffers no final)
+    unsigned long long numPortas;
+    unsigned long long numBuffers;
+    std::vector<unsigned long long> deslocamento;
+    std::vector<unsigned long long> posSaida;
+  };
+
+  // Definicoes na ordem do arquivo; a ultima eh o circuito principal
+  std::vector<Definicao> defs;
+  std::map<std::string,unsigned> nomes;
+  // Pilha de trabalho para a simulacao
+  std::vector<bool3S_64> pilha;
+
+  // Leh o corpo (CIRCUITO: ... PORTAS: ... SAIDAS: ...) de uma definicao, cuja primeira
+  // palavra (Primeiro) jah foi lida
+  bool lerCorpo(std::istream& I, const std::string& Primeiro, Definicao& D);
+  // Calcula a ordem de avaliacao e os dados de achatamento de uma definicao
+  void compilar(Definicao& D);
+  // Avalia uma definicao com os sinais locais em L (entradas jah fixadas)
+  void avaliar(unsigned D, bool3S_64* L) const;
+  // Posicao no circuito achatado do sinal local S (nao entrada) da definicao D
+  unsigned long long posLocal(const Definicao& D, unsigned S) const;
+  // Gera no circuito achatado as portas de uma instancia da definicao D
+  void expandir(unsigned D, unsigned long long Base, const std::vector<int>& IdsEntrada, Circuit& C) const;
+  // Imprime o corpo de uma definicao
+  void imprimirCorpo(std::ostream& O, const Definicao& D) const;
+
+public:
+  /// ***********************
+  /// Inicializacao e E/S
+  /// ***********************
+
+  CircuitoHierarquico() {}
+
+  void clear();
+
+  // Leh um circuito hierarquico da stream I ou do arquivo arq
+  // Em caso de erro, imprime uma mensagem em cerr, limpa o circuito e retorna false
+  bool ler(std::istream& I);
+  bool ler(const std::string& arq);
+
+  // Imprime o circuito no mesmo formato da leitura
+  std::ostream& imprimir(std::ostream& O=std::cout) const;
+
+  // Gera o circuito achatado equivalente (sem subcircuitos)
+  // Retorna false se o circuito estiver vazio ou se o achatado for grande demais
+  bool achatar(Circuit& C) const;
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumInputs() const {return defs.empty() ? 0 : defs.back().Nin;}
+  unsigned getNumOutputs() const {return defs.empty() ? 0 : defs.back().saidas.size();}
+  // Numero de definicoes de subcircuito (sem contar o circuito principal)
+  unsigned getNumDefinicoes() const {return defs.empty() ? 0 : defs.size()-1;}
+  // Numero de elementos (portas e instancias) armazenados em todas as definicoes
+  unsigned long long getNumElementos() const;
+  // Numero de portas do circuito achatado
+  unsigned long long getNumPortasAchatado() const {return defs.empty() ? 0 : defs.back().numPortas;}
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Simula o circuito para 64 vetores de entrada ao mesmo tempo
+  // In deve ter getNumInputs() elementos e Out, getNumOutputs()
+  void simular(const bool3S_64* In, bool3S_64* Out);
+
+  // Simula o circuito para um unico vetor de entradas
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ);
+
+  // Simula os estimulos da stream I (ver estimulo.h), 64 vetores por vez, sem achatar o
+  // circuito, e escreve em O uma linha "entradas TAB saidas" por vetor (como simularFluxo)
+  // Retorna false (com uma mensagem em cerr) se o circuito ou algum estimulo for invalido;
+  // nesse caso, os vetores anteriores ao erro jah foram escritos.
+  // Se NumVetores != nullptr, recebe o numero de vetores simulados
+  bool simularEstimulos(std::istream& I, std::ostream& O, unsigned long long* NumVetores=nullptr);
+};
+
+// Retorna true se o arquivo arq contem um circuito hierarquico (comeca por SUBCIRCUITO)
+bool arquivoHierarquico(const std::string& arq);
+
+#endif // _HIERARQUIA_H_
@@ -0,0 +1,537 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "importar.h"
+#include "rastro.h"
+
+///
+/// CONSTRUCAO DA NETLIST A PARTIR DE SINAIS NOMEADOS
+///
+
+// Classe auxiliar comum aos dois importadores: guarda os sinais (redes) nomeados,
+// as portas que os definem, as entradas e as saidas, e no final monta o Circuit.
+class ConstrutorNetlist {
+private:
+  // Como um sinal eh definido
+  enum class Def {NENHUMA, ENTRADA, PORTA, APELIDO};
+
+  struct Rede {
+    Def def;
+    unsigned ref;   // indice da entrada, da porta ou da rede apelidada
+    std::string nome;
+  };
+
+  struct PortaImp {
+    std::string tipo;              // AN, NA, OR, NO, XO, NX, NT ou FF
+    std::vector<unsigned> entradas; // indices de redes
+  };
+
+  std::unordered_map<std::string,unsigned> nomes;
+  std::vector<Rede> redes;
+  std::vector<unsigned> entradas;  // redes que sao entradas do circuito
+  std::vector<unsigned> saidas;    // redes que sao saidas do circuito
+  std::vector<PortaImp> portas;
+
+  // Marca a rede R como definida; retorna false se jah estava
+  bool definir(unsigned R, Def D, unsigned Ref);
+
+  // Segue a cadeia de apelidos (buffers) ateh a rede que realmente define o sinal
+  // Retorna false se a cadeia for um laco de buffers
+  bool resolver(unsigned& R) const;
+
+public:
+  // Nome do formato, para as mensagens de erro
+  std::string formato;
+  // Linha atual do arquivo, para as mensagens de erro
+  unsigned linha;
+
+  ConstrutorNetlist(const std::string& Formato): formato(Formato), linha(0) {}
+
+  // Retorna o indice da rede com esse nome (criando-a, se necessario)
+  unsigned rede(const std::string& Nome);
+  // Cria uma rede interna, sem nome
+  unsigned redeAnonima();
+
+  bool entrada(unsigned R);
+  void saida(unsigned R);
+  bool porta(const std::string& Tipo, const std::vector<unsigned>& Entradas, unsigned Saida);
+  bool buffer(unsigned Entrada, unsigned Saida);
+  bool sequencial(unsigned Entrada, unsigned Saida);
+
+  // Imprime uma mensagem de erro com o numero da linha e retorna false
+  bool erro(const std::string& Msg) const;
+
+  // Monta o Circuit (resolvendo apelidos e decompondo portas com muitas entradas)
+  bool construir(Circuit& C);
+};
+
+bool ConstrutorNetlist::erro(const std::string& Msg) const
+{
+  std::cerr << formato;
+  if (linha>0) std::cerr << " (linha " << linha << ")";
+  std::cerr << ": " << Msg << "\n\n";
+  return false;
+}
+
+unsigned ConstrutorNetlist::rede(const std::string& Nome)
+{
+  auto it = nomes.find(Nome);
+  if (it != nomes.end()) return it->second;
+  redes.push_back({Def::NENHUMA, 0, Nome});
+  nomes[Nome] = redes.size()-1;
+  return redes.size()-1;
+}
+
+unsigned ConstrutorNetlist::redeAnonima()
+{
+  redes.push_back({Def::NENHUMA, 0, ""});
+  return redes.size()-1;
+}
+
+bool ConstrutorNetlist::definir(unsigned R, Def D, unsigned Ref)
+{
+  if (redes[R].def != Def::NENHUMA) return erro("sinal " + redes[R].nome + " definido mais de uma vez");
+  redes[R].def = D;
+  redes[R].ref = Ref;
+  return true;
+}
+
+bool ConstrutorNetlist::entrada(unsigned R)
+{
+  entradas.push_back(R);
+  return definir(R, Def::ENTRADA, entradas.size()-1);
+}
+
+void ConstrutorNetlist::saida(unsigned R)
+{
+  saidas.push_back(R);
+}
+
+bool ConstrutorNetlist::porta(const std::string& Tipo, const std::vector<unsigned>& Entradas, unsigned Saida)
+{
+  if (Entradas.empty()) return erro("porta sem entradas");
+  // Portas de uma entrada: AND/OR/XOR viram buffer; NAND/NOR/XNOR viram NOT
+  if (Entradas.size()==1 && Tipo!="NT")
+  {
+    if (Tipo=="AN" || Tipo=="OR" || Tipo=="XO") return buffer(Entradas[0], Saida);
+    portas.push_back({"NT", Entradas});
+  }
+  else
+  {
+    if (Tipo=="NT" && Entradas.size()!=1) return erro("porta NOT com mais de uma entrada");
+    portas.push_back({Tipo, Entradas});
+  }
+  return definir(Saida, Def::PORTA, portas.size()-1);
+}
+
+bool ConstrutorNetlist::buffer(unsigned Entrada, unsigned Saida)
+{
+  return definir(Saida, Def::APELIDO, Entrada);
+}
+
+bool ConstrutorNetlist::sequencial(unsigned Entrada, unsigned Saida)
+{
+  portas.push_back({"FF", {Entrada}});
+  return definir(Saida, Def::PORTA, portas.size()-1);
+}
+
+bool ConstrutorNetlist::resolver(unsigned& R) const
+{
+  for (size_t passos=0; redes[R].def==Def::APELIDO; passos++)
+  {
+    if (passos > redes.size()) return false;
+    R = redes[R].ref;
+  }
+  return true;
+}
+
+bool ConstrutorNetlist::construir(Circuit& C)
+{
+  linha = 0;
+  C.clear();
+
+  // Portas geradas no Circuit: as entradas de cada porta sao codificadas como
+  // >=0: indice de rede; <0: -(indice da porta gerada + 1)
+  std::vector<std::string> tipoGer;
+  std::vector<std::vector<long>> entrGer;
+  // Porta gerada (raiz da arvore) que define cada porta importada
+  std::vector<unsigned> raiz(portas.size());
+
+  for (unsigned p=0; p<portas.size(); p++)
+  {
+    const PortaImp& P = portas[p];
+    std::vector<long> nivel;
+    for (unsigned r : P.entradas) nivel.push_back(long(r));
+    // Decomposicao: a arvore usa o tipo base (AN, OR, XO); a inversao fica na raiz
+    std::string base = P.tipo;
+    if (base=="NA") base = "AN";
+    else if (base=="NO") base = "OR";
+    else if (base=="NX") base = "XO";
+    while (nivel.size() > MAX_ENTRADAS_IMPORT)
+    {
+      std::vector<long> prox;
+      for (size_t i=0; i<nivel.size(); i+=MAX_ENTRADAS_IMPORT)
+      {
+        size_t fim = std::min(nivel.size(), i+MAX_ENTRADAS_IMPORT);
+        if (fim-i == 1) {prox.push_back(nivel[i]); continue;}
+        tipoGer.push_back(base);
+        entrGer.push_back(std::vector<long>(nivel.begin()+i, nivel.begin()+fim));
+        prox.push_back(-long(tipoGer.size()));
+      }
+      nivel.swap(prox);
+    }
+    tipoGer.push_back(P.tipo);
+    entrGer.push_back(nivel);
+    raiz[p] = tipoGer.size()-1;
+  }
+
+  // Id no Circuit do sinal definido por uma rede
+  auto idRede = [&](unsigned R, int& Id) -> bool
+  {
+    if (!resolver(R)) return erro("laco de buffers no sinal " + redes[R].nome);
+    if (redes[R].def==Def::ENTRADA) {Id = -int(redes[R].ref+1); return true;}
+    if (redes[R].def==Def::PORTA) {Id = int(raiz[redes[R].ref]+1); return true;}
+    return erro("sinal " + redes[R].nome + " usado mas nao definido");
+  };
+
+  if (entradas.empty()) return erro("circuito sem entradas");
+  if (saidas.empty()) return erro("circuito sem saidas");
+  if (tipoGer.empty()) return erro("circuito sem portas");
+
+  C.resize(entradas.size(), saidas.size(), tipoGer.size());
+  for (unsigned g=0; g<tipoGer.size(); g++)
+  {
+    C.setPort(g+1, tipoGer[g], entrGer[g].size());
+    for (unsigned j=0; j<entrGer[g].size(); j++)
+    {
+      int id;
+      if (entrGer[g][j] < 0) id = int(-entrGer[g][j]);
+      else if (!idRede(entrGer[g][j], id)) {C.clear(); return false;}
+      C.setId_inPort(g+1, j, id);
+    }
+  }
+  for (unsigned s=0; s<saidas.size(); s++)
+  {
+    int id;
+    if (!idRede(saidas[s], id)) {C.clear(); return false;}
+    C.setIdOutput(s+1, id);
+  }
+  if (!C.valid())
+  {
+    C.clear();
+    return erro("circuito resultante invalido");
+  }
+  return true;
+}
+
+///
+/// Funcoes auxiliares de leitura
+///
+
+// Remove espacos do inicio e do fim de uma string
+static std::string aparar(const std::string& S)
+{
+  size_t ini = S.find_first_not_of(" \t\r\n");
+  if (ini==std::string::npos) return "";
+  size_t fim = S.find_last_not_of(" \t\r\n");
+  return S.substr(ini, fim-ini+1);
+}
+
+// Converte o nome de uma porta nos formatos externos para a sigla do projeto
+// Retorna "BF" para buffer, "FF" para flip-flop e "" se desconhecido
+static std::string siglaExterna(std::string Nome)
+{
+  for (char& c : Nome) c = toupper(c);
+  if (Nome=="AND") return "AN";
+  if (Nome=="NAND") return "NA";
+  if (Nome=="OR") return "OR";
+  if (Nome=="NOR") return "NO";
+  if (Nome=="XOR") return "XO";
+  if (Nome=="XNOR" || Nome=="NXOR") return "NX";
+  if (Nome=="NOT" || Nome=="INV") return "NT";
+  if (Nome=="BUFF" || Nome=="BUF") return "BF";
+  if (Nome=="DFF") return "FF";
+  return "";
+}
+
+///
+/// IMPORTADOR .bench
+///
+
+// Formato (uma declaracao por linha; '#' inicia comentario):
+// INPUT(G1)
+// OUTPUT(G22)
+// G10 = NAND(G1, G3)
+bool importarBench(std::istream& ArqI, Circuit& C)
+{
+  ConstrutorNetlist N("bench");
+  std::string lin;
+  RASTRO_ESCOPO("importarBench");
+
+  C.clear();
+  while (std::getline(ArqI, lin))
+  {
+    N.linha++;
+    size_t com = lin.find('#');
+    if (com!=std::string::npos) lin.erase(com);
+    lin = aparar(lin);
+    if (lin.empty()) continue;
+
+    size_t abre = lin.find('('), fecha = lin.rfind(')');
+    if (abre==std::string::npos || fecha==std::string::npos || fecha<abre)
+    {
+      return N.erro("declaracao invalida: " + lin);
+    }
+    std::string args = lin.substr(abre+1, fecha-abre-1);
+    size_t igual = lin.find('=');
+
+    if (igual==std::string::npos)
+    {
+      // INPUT(x) ou OUTPUT(x)
+      std::string chave = aparar(lin.substr(0, abre));
+      for (char& c : chave) c = toupper(c);
+      unsigned R = N.rede(aparar(args));
+      if (chave=="INPUT") {if (!N.entrada(R)) return false;}
+      else if (chave=="OUTPUT") N.saida(R);
+      else return N.erro("palavra chave desconhecida: " + chave);
+      continue;
+    }
+
+    // saida = TIPO(entradas)
+    unsigned saida = N.rede(aparar(lin.substr(0, igual)));
+    std::string tipo = siglaExterna(aparar(lin.substr(igual+1, abre-igual-1)));
+    if (tipo.empty()) return N.erro("tipo de porta desconhecido: " + lin);
+    std::vector<unsigned> ent;
+    std::stringstream ss(args);
+    std::string nome;
+    while (std::getline(ss, nome, ','))
+    {
+      nome = aparar(nome);
+      if (nome.empty()) return N.erro("entrada vazia: " + lin);
+      ent.push_back(N.rede(nome));
+    }
+    bool ok;
+    if (tipo=="BF") ok = (ent.size()==1) ? N.buffer(ent[0], saida) : N.erro("buffer com mais de uma entrada");
+    else if (tipo=="FF") ok = (ent.size()==1) ? N.sequencial(ent[0], saida) : N.erro("DFF com mais de uma entrada");
+    else ok = N.porta(tipo, ent, saida);
+    if (!ok) return false;
+  }
+  return N.construir(C);
+}
+
+bool importarBench(const std::string& arq, Circuit& C)
+{
+  std::ifstream arquivo(arq);
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  return importarBench(arquivo, C);
+}
+
+///
+/// IMPORTADOR BLIF
+///
+
+// Leh uma linha logica do BLIF: junta as continuacoes ('\' no fim da linha),
+// remove comentarios e separa em palavras. Retorna false no fim do arquivo.
+static bool lerLinhaBLIF(std::istream& ArqI, ConstrutorNetlist& N, std::vector<std::string>& Pal)
+{
+  std::string lin, parte;
+  Pal.clear();
+  while (Pal.empty())
+  {
+    lin.clear();
+    bool continua = true;
+    while (continua)
+    {
+      if (!std::getline(ArqI, parte)) {if (lin.empty()) return false; break;}
+      N.linha++;
+      size_t com = parte.find('#');
+      if (com!=std::string::npos) parte.erase(com);
+      parte = aparar(parte);
+      continua = (!parte.empty() && parte.back()=='\\');
+      if (continua) parte.pop_back();
+      lin += parte + ' ';
+    }
+    std::stringstream ss(lin);
+    std::string p;
+    while (ss >> p) Pal.push_back(p);
+  }
+  return true;
+}
+
+// Converte a cobertura de um .names em portas
+// Ent: redes de entrada; Saida: rede definida; Linhas: pares (cubo, fase)
+static bool converterNames(ConstrutorNetlist& N, const std::vector<unsigned>& Ent, unsigned Saida,
+                           const std::vector<std::pair<std::string,char>>& Linhas,
+                           std::unordered_map<unsigned,unsigned>& Negadas)
+{
+  if (Ent.empty() || Linhas.empty())
+  {
+    return N.erro("sinais constantes nao sao suportados (nao ha porta constante)");
+  }
+  char fase = Linhas[0].second;
+  for (auto& L : Linhas)
+  {
+    if (L.first.size()!=Ent.size()) return N.erro("cubo com numero de entradas errado");
+    if (L.second!=fase || (fase!='0' && fase!='1')) return N.erro("fase de saida invalida");
+  }
+  bool inv = (fase=='0');
+
+  // Buffer e NOT
+  if (Ent.size()==1 && Linhas.size()==1 && Linhas[0].first!="-")
+  {
+    bool direto = (Linhas[0].first=="1") != inv;
+    if (direto) return N.buffer(Ent[0], Saida);
+    return N.porta("NT", Ent, Saida);
+  }
+  // XOR e XNOR de 2 entradas
+  if (Ent.size()==2 && Linhas.size()==2)
+  {
+    std::string a = Linhas[0].first, b = Linhas[1].first;
+    if (a>b) std::swap(a,b);
+    if ((a=="01" && b=="10") || (a=="00" && b=="11"))
+    {
+      bool xo = (a=="01") != inv;
+      return N.porta(xo ? "XO" : "NX", Ent, Saida);
+    }
+  }
+
+  // Literal de uma entrada (a propria rede ou sua negacao, criada uma unica vez)
+  auto literal = [&](unsigned i, char v) -> unsigned
+  {
+    if (v=='1') return Ent[i];
+    auto it = Negadas.find(Ent[i]);
+    if (it!=Negadas.end()) return it->second;
+    unsigned R = N.redeAnonima();
+    N.porta("NT", {Ent[i]}, R);
+    Negadas[Ent[i]] = R;
+    return R;
+  };
+
+  // Soma de produtos: cada cubo vira um AND dos literais; os cubos sao combinados por um OR.
+  // A ultima porta (a que define a saida) absorve a inversao quando a fase eh 0.
+  std::vector<std::vector<unsigned>> cubos;
+  for (auto& L : Linhas)
+  {
+    std::vector<unsigned> lit;
+    for (unsigned i=0; i<L.first.size(); i++)
+    {
+      char v = L.first[i];
+      if (v=='-') continue;
+      if (v!='0' && v!='1') return N.erro("caractere invalido no cubo: " + L.first);
+      lit.push_back(literal(i, v));
+    }
+    if (lit.empty()) return N.erro("cubo tautologico (saida constante) nao eh suportado");
+    cubos.push_back(lit);
+  }
+  if (cubos.size()==1)
+  {
+    if (cubos[0].size()==1) return inv ? N.porta("NT", cubos[0], Saida) : N.buffer(cubos[0][0], Saida);
+    return N.porta(inv ? "NA" : "AN", cubos[0], Saida);
+  }
+  std::vector<unsigned> termos;
+  for (auto& cubo : cubos)
+  {
+    if (cubo.size()==1) {termos.push_back(cubo[0]); continue;}
+    unsigned R = N.redeAnonima();
+    if (!N.porta("AN", cubo, R)) return false;
+    termos.push_back(R);
+  }
+  return N.porta(inv ? "NO" : "OR", termos, Saida);
+}
+
+// Formato (subconjunto combinacional do BLIF):
+// .model nome
+// .inputs a b c
+// .outputs y
+// .names a b y
+// 11 1
+// .latch d q [tipo controle] [valor inicial]
+// .end
+bool importarBLIF(std::istream& ArqI, Circuit& C)
+{
+  ConstrutorNetlist N("blif");
+  std::vector<std::string> pal;
+  std::unordered_map<unsigned,unsigned> negadas;
+  RASTRO_ESCOPO("importarBLIF");
+  bool temLinha = lerLinhaBLIF(ArqI, N, pal);
+
+  C.clear();
+  while (temLinha)
+  {
+    const std::string& cmd = pal[0];
+    if (cmd==".model")
+    {
+      temLinha = lerLinhaBLIF(ArqI, N, pal);
+    }
+    else if (cmd==".inputs" || cmd==".outputs")
+    {
+      for (size_t i=1; i<pal.size(); i++)
+      {
+        unsigned R = N.rede(pal[i]);
+        if (cmd==".inputs") {if (!N.entrada(R)) return false;}
+        else N.saida(R);
+      }
+      temLinha = lerLinhaBLIF(ArqI, N, pal);
+    }
+    else if (cmd==".names")
+    {
+      if (pal.size()<2) return N.erro(".names sem sinais");
+      std::vector<unsigned> ent;
+      for (size_t i=1; i+1<pal.size(); i++) ent.push_back(N.rede(pal[i]));
+      unsigned saida = N.rede(pal.back());
+      // As linhas seguintes (ateh o proximo comando) sao a cobertura
+      std::vector<std::pair<std::string,char>> linhas;
+      while ((temLinha = lerLinhaBLIF(ArqI, N, pal)) && pal[0][0]!='.')
+      {
+        if (ent.empty() && pal.size()==1) linhas.push_back({"", pal[0][0]});
+        else if (pal.size()==2 && pal[1].size()==1) linhas.push_back({pal[0], pal[1][0]});
+        else return N.erro("linha de cobertura invalida");
+      }
+      if (!converterNames(N, ent, saida, linhas, negadas)) return false;
+    }
+    else if (cmd==".latch")
+    {
+      if (pal.size()<3) return N.erro(".latch sem entrada ou saida");
+      if (!N.sequencial(N.rede(pal[1]), N.rede(pal[2]))) return false;
+      temLinha = lerLinhaBLIF(ArqI, N, pal);
+    }
+    else if (cmd==".end")
+    {
+      break;
+    }
+    else
+    {
+      return N.erro("comando nao suportado: " + cmd);
+    }
+  }
+  return N.construir(C);
+}
+
+bool importarBLIF(const std::string& arq, Circuit& C)
+{
+  std::ifstream arquivo(arq);
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao abrir arquivo " << arq << "\n\n";
+    return false;
+  }
+  return importarBLIF(arquivo, C);
+}
+
+// Escolhe o importador pela extensao do arquivo (.bench ou .blif)
+bool importarCircuito(const std::string& arq, Circuit& C)
+{
+  size_t ponto = arq.rfind('.');
+  std::string ext = (ponto==std::string::npos) ? "" : arq.substr(ponto+1);
+  for (char& c : ext) c = tolower(c);
+  if (ext=="bench") return importarBench(arq, C);
+  if (ext=="blif") return importarBLIF(arq, C);
+  std::cerr << "Formato de arquivo desconhecido: " << arq << "\n\n";
+  return false;
+}
@@ -0,0 +1,41 @@
+#ifndef _IMPORTAR_H_
+#define _IMPORTAR_H_
+
+#include <iostream>
+#include <string>
+#include "circuit.h"
+
+///
+/// IMPORTADORES DE NETLISTS EM OUTROS FORMATOS
+///
+
+// Leem netlists nos formatos ISCAS .bench e BLIF e montam um Circuit equivalente.
+// Os sinais nomeados sao mapeados para a convencao de ids do projeto:
+// - as entradas do circuito recebem as ids -1, -2, ... na ordem em que sao declaradas;
+// - cada porta recebe uma id positiva (1, 2, ...); a saida de uma porta eh o sinal que ela define.
+// Tipos reconhecidos: AND, NAND, OR, NOR, XOR, XNOR, NOT e BUFF (ou BUF).
+// - Os buffers nao geram portas: o sinal de saida passa a ser um apelido do sinal de entrada.
+// - Portas com mais de MAX_ENTRADAS_IMPORT entradas sao decompostas em arvores de portas.
+// - Os elementos sequenciais (DFF do .bench, .latch do BLIF) viram flip-flops (FF).
+//   O valor inicial do .latch eh ignorado: o estado inicial dos flip-flops eh UNDEF.
+// A leitura eh feita linha a linha (sem carregar o arquivo inteiro na memoria).
+// Em caso de erro, imprime uma mensagem em cerr, limpa o circuito e retorna false.
+
+// Numero maximo de entradas das portas geradas pelos importadores
+const unsigned MAX_ENTRADAS_IMPORT = 4;
+
+// Importa um circuito no formato ISCAS-85/89 (.bench)
+bool importarBench(std::istream& ArqI, Circuit& C);
+bool importarBench(const std::string& arq, Circuit& C);
+
+// Importa um circuito no formato BLIF (apenas o primeiro .model, sem hierarquia)
+// Cada .names eh convertido em uma soma de produtos (portas AND/OR/NOT); as coberturas
+// mais comuns (AND, OR, NAND, NOR, XOR, XNOR, NOT, buffer) geram uma unica porta.
+bool importarBLIF(std::istream& ArqI, Circuit& C);
+bool importarBLIF(const std::string& arq, Circuit& C);
+
+// Escolhe o importador pela extensao do arquivo (.bench ou .blif)
+// Retorna false se a extensao nao for reconhecida ou se houver erro na leitura
+bool importarCircuito(const std::string& arq, Circuit& C);
+
+#endif // _IMPORTAR_H_
@@ -0,0 +1,391 @@
+#include <cstring>
+#include <cstdint>
+#include "jit.h"
+#include "rastro.h"
+
+// O JIT soh existe em x86-64 com a convencao System V (o vetor de sinais chega em RDI)
+#if !defined(CIRCUITO_SEM_JIT) && defined(__x86_64__) && !defined(_WIN32)
+#define JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+#ifdef JIT_X86_64
+
+///
+/// Montador minimo de x86-64 (apenas as instrucoes usadas pelo JIT)
+///
+
+// Registradores de 64 bits
+enum Reg : unsigned {RAX=0, RCX=1, RDX=2, RBX=3, RSP=4, RBP=5, RSI=6, RDI=7,
+                     R8=8, R9, R10, R11, R12, R13, R14, R15};
+
+// Opcodes "reg <- reg op r/m" (com REX.W)
+static const uint8_t OP_MOV = 0x8B, OP_AND = 0x23, OP_OR = 0x0B, OP_XOR = 0x33;
+
+// Um operando: um registrador ou a posicao [RDI+desl] do vetor de sinais
+struct Operando {
+  bool registrador;
+  unsigned reg;
+  int32_t desl;
+};
+
+static Operando emReg(unsigned R) {return Operando{true, R, 0};}
+static Operando naMemoria(int32_t Desl) {return Operando{false, 0, Desl};}
+
+class Montador {
+public:
+  std::vector<uint8_t> bytes;
+
+  void byte(uint8_t B) {bytes.push_back(B);}
+  void dword(uint32_t D) {for (unsigned k=0; k<4; k++) byte(uint8_t(D >> (8*k)));}
+
+  // reg <- reg op X (Op: OP_MOV, OP_AND, ...)
+  void op(uint8_t Op, unsigned R, const Operando& X)
+  {
+    if (X.registrador)
+    {
+      if (Op==OP_MOV && R==X.reg) return;
+      byte(0x48 | ((R>>3)<<2) | (X.reg>>3));
+      byte(Op);
+      byte(0xC0 | ((R&7)<<3) | (X.reg&7));
+    }
+    else
+    {
+      byte(0x48 | ((R>>3)<<2));
+      byte(Op);
+      byte(0x80 | ((R&7)<<3) | RDI);
+      dword(uint32_t(X.desl));
+    }
+  }
+  // [RDI+Desl] <- reg
+  void guardar(int32_t Desl, unsigned R)
+  {
+    byte(0x48 | ((R>>3)<<2));
+    byte(0x89);
+    byte(0x80 | ((R&7)<<3) | RDI);
+    dword(uint32_t(Desl));
+  }
+  // reg <- ~reg
+  void negar(unsigned R)
+  {
+    byte(0x48 | (R>>3));
+    byte(0xF7);
+    byte(0xC0 | (2<<3) | (R&7));
+  }
+  // push/pop de um registrador
+  void empilhar(unsigned R) {if (R>=8) byte(0x41); byte(0x50 | (R&7));}
+  void desempilhar(unsigned R) {if (R>=8) byte(0x41); byte(0x58 | (R&7));}
+  // reg <- 0 (xor de 32 bits, que zera os 64 bits)
+  void zerar(unsigned R)
+  {
+    if (R>=8) byte(0x45);
+    byte(0x31);
+    byte(0xC0 | ((R&7)<<3) | (R&7));
+  }
+  // test reg, reg
+  void testar(unsigned R)
+  {
+    byte(0x48 | ((R>>3)<<2) | (R>>3));
+    byte(0x85);
+    byte(0xC0 | ((R&7)<<3) | (R&7));
+  }
+  // jnz para a posicao Destino do codigo
+  void saltarSeNaoZero(size_t Destino)
+  {
+    byte(0x0F);
+    byte(0x85);
+    dword(uint32_t(int32_t(Destino) - int32_t(bytes.size()+4)));
+  }
+  void retornar() {byte(0xC3);}
+};
+
+// Registradores salvos pela funcao chamada (System V), usados na cache
+static const unsigned SALVOS[] = {RBX, RBP, R12, R13, R14, R15};
+
+static void prologo(Montador& M) {for (unsigned R : SALVOS) M.empilhar(R);}
+static void epilogo(Montador& M)
+{
+  for (unsigned k=sizeof(SALVOS)/sizeof(SALVOS[0]); k-- > 0; ) M.desempilhar(SALVOS[k]);
+  M.retornar();
+}
+
+///
+/// Geracao do codigo de 3 estados (bool3S_64: t em [RDI+16*S], f em [RDI+16*S+8])
+///
+
+// Pares de registradores da cache (t, f); RAX, RCX e RDX sao de trabalho e RSI marca
+// mudancas nos lacos
+static const unsigned PARES_CACHE = 5;
+static const unsigned CACHE_T[PARES_CACHE] = {R8, R10, RBX, R12, R14};
+static const unsigned CACHE_F[PARES_CACHE] = {R9, R11, RBP, R13, R15};
+
+static void gerar3(const Netlist& N, Montador& M)
+{
+  const unsigned Nin = N.getNumInputs();
+  const std::vector<unsigned>& ordem = N.getOrdem();
+  const unsigned laco = N.getInicioLaco();
+  unsigned cache[PARES_CACHE];
+  for (unsigned k=0; k<PARES_CACHE; k++) cache[k] = ~0u;
+  unsigned proximo = 0;
+
+  // Trilho t (F=false) ou f (F=true) do sinal S: da cache, se estiver lah
+  auto trilho = [&](unsigned S, bool F) -> Operando
+  {
+    for (unsigned k=0; k<PARES_CACHE; k++)
+    {
+      if (cache[k]==S) return emReg(F ? CACHE_F[k] : CACHE_T[k]);
+    }
+    return naMemoria(int32_t(16*S + (F ? 8 : 0)));
+  };
+
+  // Calcula a porta P; retorna em Rt e Rf os registradores com o resultado
+  auto porta = [&](unsigned P, unsigned& Rt, unsigned& Rf)
+  {
+    const unsigned* e = N.getEntradas(P);
+    const unsigned n = N.getNumInputsPort(P);
+    TipoPorta t = N.getTipo(P);
+    M.op(OP_MOV, RAX, trilho(e[0], false));
+    Rt = RAX;
+    Rf = RDX;
+    switch (t)
+    {
+    case TipoPorta::NT:
+      M.op(OP_MOV, RDX, trilho(e[0], true));
+      break;
+    case TipoPorta::AN:
+    case TipoPorta::NA:
+      M.op(OP_MOV, RDX, trilho(e[0], true));
+      for (unsigned k=1; k<n; k++)
+      {
+        M.op(OP_AND, RAX, trilho(e[k], false));
+        M.op(OP_OR, RDX, trilho(e[k], true));
+      }
+      break;
+    case TipoPorta::OR:
+    case TipoPorta::NO:
+      M.op(OP_MOV, RDX, trilho(e[0], true));
+      for (unsigned k=1; k<n; k++)
+      {
+        M.op(OP_OR, RAX, trilho(e[k], false));
+        M.op(OP_AND, RDX, trilho(e[k], true));
+      }
+      break;
+    default:
+      // XOR: paridade p dos trilhos t (RAX) e definicao d (RDX); t = p & d, f = ~p & d
+      M.op(OP_MOV, RDX, trilho(e[0], false));
+      M.op(OP_OR, RDX, trilho(e[0], true));
+      for (unsigned k=1; k<n; k++)
+      {
+        M.op(OP_XOR, RAX, trilho(e[k], false));
+        M.op(OP_MOV, RCX, trilho(e[k], false));
+        M.op(OP_OR, RCX, trilho(e[k], true));
+        M.op(OP_AND, RDX, emReg(RCX));
+      }
+      M.op(OP_MOV, RCX, emReg(RAX));
+      M.negar(RCX);
+      M.op(OP_AND, RCX, emReg(RDX));
+      M.op(OP_AND, RAX, emReg(RDX));
+      Rf = RCX;
+      break;
+    }
+    // NOT, NAND, NOR e NXOR: troca os trilhos
+    if (t==TipoPorta::NT || t==TipoPorta::NA || t==TipoPorta::NO || t==TipoPorta::NX) std::swap(Rt, Rf);
+  };
+
+  prologo(M);
+  // Parte sem lacos: cada resultado vai para a memoria e para a cache
+  for (unsigned i=0; i<laco; i++)
+  {
+    unsigned P = ordem[i];
+    if (N.getTipo(P)==TipoPorta::FF) continue;
+    unsigned Rt, Rf;
+    unsigned S = Nin+P;
+    porta(P, Rt, Rf);
+    M.guardar(int32_t(16*S), Rt);
+    M.guardar(int32_t(16*S+8), Rf);
+    cache[proximo] = S;
+    M.op(OP_MOV, CACHE_T[proximo], emReg(Rt));
+    M.op(OP_MOV, CACHE_F[proximo], emReg(Rf));
+    proximo = (proximo+1)%PARES_CACHE;
+  }
+  // Parte com lacos: parte de UNDEF e reavalia ateh o ponto fixo; os sinais dos lacos
+  // nao entram na cache, que fica constante dentro do laco
+  if (laco<ordem.size())
+  {
+    M.zerar(RAX);
+    for (unsigned i=laco; i<ordem.size(); i++)
+    {
+      unsigned S = Nin+ordem[i];
+      if (N.getTipo(ordem[i])==TipoPorta::FF) continue;
+      M.guardar(int32_t(16*S), RAX);
+      M.guardar(int32_t(16*S+8), RAX);
+    }
+    size_t inicio = M.bytes.size();
+    M.zerar(RSI);
+    for (unsigned i=laco; i<ordem.size(); i++)
+    {
+      unsigned P = ordem[i];
+      if (N.getTipo(P)==TipoPorta::FF) continue;
+      unsigned Rt, Rf;
+      unsigned S = Nin+P;
+      porta(P, Rt, Rf);
+      // RSI |= (novo ^ antigo); o segundo xor restaura o valor novo
+      Operando t = naMemoria(int32_t(16*S)), f = naMemoria(int32_t(16*S+8));
+      M.op(OP_XOR, Rt, t);
+      M.op(OP_OR, RSI, emReg(Rt));
+      M.op(OP_XOR, Rt, t);
+      M.op(OP_XOR, Rf, f);
+      M.op(OP_OR, RSI, emReg(Rf));
+      M.op(OP_XOR, Rf, f);
+      M.guardar(t.desl, Rt);
+      M.guardar(f.desl, Rf);
+    }
+    M.testar(RSI);
+    M.saltarSeNaoZero(inicio);
+  }
+  epilogo(M);
+}
+
+///
+/// Geracao do codigo de 2 estados (uint64_t em [RDI+8*S]), sem lacos e sem flip-flops
+///
+
+static const unsigned REGS_CACHE = 10;
+static const unsigned CACHE_2[REGS_CACHE] = {R8, R9, R10, R11, RBX, RBP, R12, R13, R14, R15};
+
+static void gerar2(const Netlist& N, Montador& M)
+{
+  const unsigned Nin = N.getNumInputs();
+  unsigned cache[REGS_CACHE];
+  for (unsigned k=0; k<REGS_CACHE; k++) cache[k] = ~0u;
+  unsigned proximo = 0;
+  auto fonte = [&](unsigned S) -> Operando
+  {
+    for (unsigned k=0; k<REGS_CACHE; k++)
+    {
+      if (cache[k]==S) return emReg(CACHE_2[k]);
+    }
+    return naMemoria(int32_t(8*S));
+  };
+
+  prologo(M);
+  for (unsigned P : N.getOrdem())
+  {
+    const unsigned* e = N.getEntradas(P);
+    const unsigned n = N.getNumInputsPort(P);
+    TipoPorta t = N.getTipo(P);
+    uint8_t Op = (t==TipoPorta::AN || t==TipoPorta::NA) ? OP_AND :
+                 (t==TipoPorta::OR || t==TipoPorta::NO) ? OP_OR : OP_XOR;
+    M.op(OP_MOV, RAX, fonte(e[0]));
+    for (unsigned k=1; k<n; k++) M.op(Op, RAX, fonte(e[k]));
+    if (t==TipoPorta::NT || t==TipoPorta::NA || t==TipoPorta::NO || t==TipoPorta::NX) M.negar(RAX);
+    M.guardar(int32_t(8*(Nin+P)), RAX);
+    cache[proximo] = Nin+P;
+    M.op(OP_MOV, CACHE_2[proximo], emReg(RAX));
+    proximo = (proximo+1)%REGS_CACHE;
+  }
+  epilogo(M);
+}
+
+#endif // JIT_X86_64
+
+///
+/// CLASSE SIMULADORJIT
+///
+
+SimuladorJIT::SimuladorJIT():
+  codigo(nullptr), tamanho(0), funcao3(nullptr), funcao2(nullptr), ligado(true) {}
+
+// Compila o circuito C (ver compilar)
+SimuladorJIT::SimuladorJIT(const Circuit& C): SimuladorJIT()
+{
+  compilar(C);
+}
+
+SimuladorJIT::~SimuladorJIT() {liberarCodigo();}
+
+// Retorna true se o JIT existe nesta plataforma
+bool SimuladorJIT::suportado()
+{
+#ifdef JIT_X86_64
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Libera a memoria do codigo gerado
+void SimuladorJIT::liberarCodigo()
+{
+#ifdef JIT_X86_64
+  if (codigo!=nullptr) munmap(codigo, tamanho);
+#endif
+  codigo = nullptr;
+  tamanho = 0;
+  funcao3 = nullptr;
+  funcao2 = nullptr;
+}
+
+// Esvazia o simulador
+void SimuladorJIT::clear()
+{
+  liberarCodigo();
+  N.clear();
+}
+
+// Compila o circuito C para a netlist e, se suportado, gera o codigo nativo
+bool SimuladorJIT::compilar(const Circuit& C)
+{
+  RASTRO_ESCOPO("compilar JIT");
+  clear();
+  if (!N.compilar(C)) return false;
+#ifdef JIT_X86_64
+  // Os deslocamentos no vetor de sinais tem 32 bits
+  if (uint64_t(N.getNumSinais())*16 >= (uint64_t(1) << 31)) return true;
+  Montador M;
+  gerar3(N, M);
+  size_t inicio2 = M.bytes.size();
+  if (N.binaria()) gerar2(N, M);
+  size_t T = M.bytes.size();
+  void* mem = mmap(nullptr, T, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem==MAP_FAILED) return true;
+  std::memcpy(mem, M.bytes.data(), T);
+  if (mprotect(mem, T, PROT_READ | PROT_EXEC)!=0)
+  {
+    munmap(mem, T);
+    return true;
+  }
+  codigo = mem;
+  tamanho = T;
+  uint8_t* base = static_cast<uint8_t*>(mem);
+  funcao3 = reinterpret_cast<void (*)(bool3S_64*)>(base);
+  if (N.binaria()) funcao2 = reinterpret_cast<void (*)(uint64_t*)>(base+inicio2);
+#endif
+  return true;
+}
+
+// Simula 64 vetores ao mesmo tempo
+void SimuladorJIT::simular(bool3S_64* Sinais, const bool3S_64* Forca) const
+{
+  if (ligado && funcao3!=nullptr && Forca==nullptr) funcao3(Sinais);
+  else N.simular(Sinais, Forca);
+}
+
+// Simula 64 vetores com 2 valores
+void SimuladorJIT::simularBinario(uint64_t* Sinais) const
+{
+  if (ligado && funcao2!=nullptr) funcao2(Sinais);
+  else N.simularBinario(Sinais);
+}
+
+// Simula um unico vetor (com os flip-flops em UNDEF)
+bool SimuladorJIT::simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const
+{
+  if (in_circ.size()!=N.getNumInputs() || N.getNumPorts()==0) return false;
+  std::vector<bool3S_64> S(N.getNumSinais(), bool3S_64{0,0});
+  for (unsigned i=0; i<N.getNumInputs(); i++) S[i] = difundir(in_circ[i]);
+  simular(S.data());
+  out_circ.resize(N.getNumOutputs());
+  for (unsigned j=0; j<N.getNumOutputs(); j++) out_circ[j] = lerPista(S[N.getSaida(j)], 0);
+  return true;
+}
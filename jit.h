@@ -0,0 +1,89 @@
+#ifndef _JIT_H_
+#define _JIT_H_
+
+#include <cstddef>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SIMULACAO COM CODIGO NATIVO GERADO EM TEMPO DE EXECUCAO (JIT x86-64)
+///
+
+// Traduz a netlist levelizada para codigo de maquina x86-64, em uma area de memoria
+// executavel (mmap), de modo que a simulacao nao tem o custo de interpretar a netlist
+// (switch por tipo de porta, leitura dos indices das entradas etc.). Ha duas funcoes:
+// - 3 estados (bool3S_64): os dois trilhos (t, f) de cada sinal em dois registradores de
+//   64 bits; AND/OR/XOR/NOT usam as mesmas formulas de bool3S_64, e NOT soh troca os
+//   registradores;
+// - 2 estados (simularBinario, se a netlist for binaria): um registrador por sinal.
+// Cada porta eh calculada em registradores e o resultado eh sempre escrito no vetor de
+// sinais; os resultados mais recentes tambem ficam em registradores (uma pequena cache),
+// de onde sao lidos pelas portas seguintes sem acesso a memoria. As portas em lacos sao
+// reavaliadas ateh que nenhuma mude, partindo de UNDEF, como em Netlist::simular.
+//
+// O JIT soh existe em x86-64 com a convencao de chamada System V (Linux, BSD, macOS) e
+// pode ser retirado na compilacao com a macro CIRCUITO_SEM_JIT (-DCIRCUITO_SEM_JIT). Sem
+// ele, ou desligado com usarJIT(false), a simulacao usa o interpretador (Netlist), com
+// exatamente os mesmos resultados.
+
+class SimuladorJIT {
+private:
+  Netlist N;
+  // Memoria executavel com o codigo gerado e o seu tamanho (em bytes)
+  void* codigo;
+  size_t tamanho;
+  // Pontos de entrada das funcoes geradas (nullptr se nao foram geradas)
+  void (*funcao3)(bool3S_64*);
+  void (*funcao2)(uint64_t*);
+  // Usar o codigo gerado (se houver)
+  bool ligado;
+
+  // Libera a memoria do codigo gerado
+  void liberarCodigo();
+
+public:
+  SimuladorJIT();
+  // Compila o circuito C (ver compilar)
+  explicit SimuladorJIT(const Circuit& C);
+  ~SimuladorJIT();
+  // O codigo gerado nao eh copiado
+  SimuladorJIT(const SimuladorJIT&) = delete;
+  void operator=(const SimuladorJIT&) = delete;
+
+  // Retorna true se o JIT existe nesta plataforma (e nao foi retirado na compilacao)
+  static bool suportado();
+
+  // Compila o circuito C para a netlist e, se suportado, gera o codigo nativo
+  // Retorna false (e deixa o simulador vazio) se o circuito nao for valido; se apenas a
+  // geracao de codigo falhar, retorna true e o simulador usa o interpretador
+  bool compilar(const Circuit& C);
+
+  // Esvazia o simulador
+  void clear();
+
+  // Liga ou desliga o uso do codigo gerado (desligado: interpretador)
+  void usarJIT(bool Ligar) {ligado = Ligar;}
+  // Retorna true se a simulacao usa codigo nativo
+  bool nativo() const {return ligado && funcao3!=nullptr;}
+  // Tamanho do codigo gerado, em bytes
+  size_t getTamanhoCodigo() const {return tamanho;}
+
+  const Netlist& getNetlist() const {return N;}
+
+  // Simula 64 vetores ao mesmo tempo (mesma interface e resultado de Netlist::simular)
+  // Com Forca != nullptr, usa sempre o interpretador
+  void simular(bool3S_64* Sinais, const bool3S_64* Forca=nullptr) const;
+
+  // Simula 64 vetores com 2 valores (mesma interface de Netlist::simularBinario)
+  // Soh pode ser usada se getNetlist().binaria()
+  void simularBinario(uint64_t* Sinais) const;
+
+  // Simula um unico vetor (com os flip-flops em UNDEF)
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const;
+};
+
+#endif // _JIT_H_
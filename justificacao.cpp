@@ -0,0 +1,324 @@
+#include <sstream>
+#include <algorithm>
+#include "justificacao.h"
+#include "rastro.h"
+
+///
+/// CLASSE Justificador
+///
+
+// Compila o circuito
+bool Justificador::inicializar(const Circuit& C)
+{
+  if (!N.compilar(C)) return false;
+  const unsigned Nin = N.getNumInputs();
+  const unsigned NS = N.getNumSinais();
+
+  // Sinais que dependem de alguma entrada do circuito (os flip-flops nao propagam)
+  controlavel.assign(NS, false);
+  for (unsigned i=0; i<Nin; i++) controlavel[i] = true;
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned P : N.getOrdem())
+    {
+      if (controlavel[Nin+P] || N.getTipo(P)==TipoPorta::FF) continue;
+      const unsigned* e = N.getEntradas(P);
+      for (unsigned k=0; k<N.getNumInputsPort(P); k++)
+      {
+        if (controlavel[e[k]])
+        {
+          controlavel[Nin+P] = true;
+          mudou = true;
+          break;
+        }
+      }
+    }
+  } while (mudou && N.realimentada());
+
+  // Entradas do cone de cada saida
+  suporte.assign(N.getNumOutputs(), std::vector<unsigned>());
+  std::vector<bool> visitado(NS);
+  std::vector<unsigned> pilha;
+  unsigned maxEntr = 1;
+  for (unsigned P=0; P<N.getNumPorts(); P++) maxEntr = std::max(maxEntr, N.getNumInputsPort(P));
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    std::fill(visitado.begin(), visitado.end(), false);
+    pilha.assign(1, N.getSaida(j));
+    visitado[N.getSaida(j)] = true;
+    while (!pilha.empty())
+    {
+      unsigned s = pilha.back();
+      pilha.pop_back();
+      if (s<Nin)
+      {
+        suporte[j].push_back(s);
+        continue;
+      }
+      if (N.getTipo(s-Nin)==TipoPorta::FF) continue;
+      const unsigned* e = N.getEntradas(s-Nin);
+      for (unsigned k=0; k<N.getNumInputsPort(s-Nin); k++)
+      {
+        if (!visitado[e[k]]) {visitado[e[k]] = true; pilha.push_back(e[k]);}
+      }
+    }
+    std::sort(suporte[j].begin(), suporte[j].end());
+  }
+
+  fila.assign(N.getNumNiveis()+1, std::vector<unsigned>());
+  naFila.assign(N.getNumPorts(), false);
+  entrPorta.resize(maxEntr);
+  sinais64.assign(N.realimentada() ? NS : 0, bool3S_64{0,0});
+  valor.assign(NS, bool3S::UNDEF);
+  simularTudo();
+  return true;
+}
+
+// Calcula os valores de todos os sinais a partir das entradas
+void Justificador::simularTudo()
+{
+  const unsigned Nin = N.getNumInputs();
+  if (N.realimentada())
+  {
+    for (unsigned i=0; i<Nin; i++) sinais64[i] = difundir(valor[i]);
+    N.simular(sinais64.data());
+    for (unsigned s=Nin; s<N.getNumSinais(); s++) valor[s] = lerPista(sinais64[s], 0);
+    return;
+  }
+  for (unsigned P : N.getOrdem())
+  {
+    const unsigned* e = N.getEntradas(P);
+    unsigned n = N.getNumInputsPort(P);
+    for (unsigned k=0; k<n; k++) entrPorta[k] = valor[e[k]];
+    valor[Nin+P] = avaliarPorta(N.getTipo(P), entrPorta.data(), n);
+  }
+}
+
+// Fixa o valor da entrada I e propaga pelos eventos, em ordem de nivel
+void Justificador::atribuir(unsigned I, bool3S V)
+{
+  const unsigned Nin = N.getNumInputs();
+  valor[I] = V;
+  if (N.realimentada())
+  {
+    simularTudo();
+    return;
+  }
+  unsigned menorNivel = N.getNumNiveis()+1;
+  auto agendar = [&](unsigned S)
+  {
+    const unsigned* f = N.getFanout(S);
+    for (unsigned k=0; k<N.getNumFanout(S); k++)
+    {
+      unsigned P = f[k];
+      if (naFila[P]) continue;
+      naFila[P] = true;
+      fila[N.getNivel(P)].push_back(P);
+      menorNivel = std::min(menorNivel, N.getNivel(P));
+    }
+  };
+  agendar(I);
+  for (unsigned nv=menorNivel; nv<=N.getNumNiveis(); nv++)
+  {
+    // Os eventos gerados aqui vao para niveis maiores
+    for (unsigned idx=0; idx<fila[nv].size(); idx++)
+    {
+      unsigned P = fila[nv][idx];
+      naFila[P] = false;
+      const unsigned* e = N.getEntradas(P);
+      unsigned n = N.getNumInputsPort(P);
+      for (unsigned k=0; k<n; k++) entrPorta[k] = valor[e[k]];
+      bool3S v = avaliarPorta(N.getTipo(P), entrPorta.data(), n);
+      if (v!=valor[Nin+P])
+      {
+        valor[Nin+P] = v;
+        agendar(Nin+P);
+      }
+    }
+    fila[nv].clear();
+  }
+}
+
+// Leva o objetivo (sinal S, valor V) ateh uma entrada livre
+bool Justificador::backtrace(unsigned S, bool3S V, unsigned& I, bool3S& Vi) const
+{
+  const unsigned Nin = N.getNumInputs();
+  unsigned passos = 0;
+  while (S>=Nin)
+  {
+    // Com lacos, o caminho pode voltar a um sinal jah visitado
+    if (++passos > N.getNumSinais()) return false;
+    unsigned P = S-Nin;
+    TipoPorta t = N.getTipo(P);
+    if (t==TipoPorta::FF) return false;
+    const unsigned* e = N.getEntradas(P);
+    unsigned n = N.getNumInputsPort(P);
+    bool inversora = (t==TipoPorta::NT || t==TipoPorta::NA || t==TipoPorta::NO || t==TipoPorta::NX);
+    bool3S w = inversora ? ~V : V;
+    unsigned esc = ~0u;
+    if (t==TipoPorta::XO || t==TipoPorta::NX)
+    {
+      // Valor que falta, supondo F nas outras entradas ainda ?
+      for (unsigned k=0; k<n; k++)
+      {
+        if (valor[e[k]]!=bool3S::UNDEF) w = w ^ valor[e[k]];
+        else if (esc==~0u && controlavel[e[k]]) esc = e[k];
+      }
+    }
+    else
+    {
+      // AND com saida T (OR com saida F): todas as entradas devem ter o valor w, entao
+      // comeca pela mais dificil (maior nivel); senao, basta uma, a mais facil
+      bool todas = (t==TipoPorta::AN || t==TipoPorta::NA) ? (w==bool3S::TRUE) :
+                   (t==TipoPorta::OR || t==TipoPorta::NO) ? (w==bool3S::FALSE) : true;
+      unsigned melhor = 0;
+      for (unsigned k=0; k<n; k++)
+      {
+        unsigned s = e[k];
+        if (valor[s]!=bool3S::UNDEF || !controlavel[s]) continue;
+        unsigned nv = (s<Nin) ? 0 : N.getNivel(s-Nin);
+        if (esc==~0u || (todas ? nv>melhor : nv<melhor))
+        {
+          esc = s;
+          melhor = nv;
+        }
+      }
+    }
+    if (esc==~0u) return false;
+    S = esc;
+    V = w;
+  }
+  if (valor[S]!=bool3S::UNDEF) return false;
+  I = S;
+  Vi = V;
+  return true;
+}
+
+// Procura cubos de entrada que dao as saidas os valores de Alvo
+bool Justificador::justificar(const std::vector<bool3S>& Alvo, ResultadoJustificacao& R,
+                              unsigned long long MaxCubos, unsigned long long MaxRetrocessos)
+{
+  RASTRO_ESCOPO("justificar");
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  R.cubos.clear();
+  R.completa = false;
+  R.numDecisoes = R.numRetrocessos = 0;
+  if (Alvo.size()!=Nout || Nin==0) return false;
+
+  for (unsigned i=0; i<Nin; i++) valor[i] = bool3S::UNDEF;
+  simularTudo();
+
+  // Decisoes: entrada e se o seu valor jah foi trocado
+  struct Decisao {
+    unsigned entrada;
+    bool trocada;
+  };
+  std::vector<Decisao> pilha;
+  while (true)
+  {
+    // Confere as saidas alvo
+    bool conflito = false;
+    int pendente = -1;
+    for (unsigned j=0; j<Nout && !conflito; j++)
+    {
+      if (Alvo[j]==bool3S::UNDEF) continue;
+      bool3S v = valor[N.getSaida(j)];
+      if (v==bool3S::UNDEF) {if (pendente<0) pendente = j;}
+      else if (v!=Alvo[j]) conflito = true;
+    }
+    bool retroceder = conflito;
+    if (!conflito && pendente<0)
+    {
+      // Todas as saidas alvo com o valor pedido: as entradas decididas formam um cubo
+      R.cubos.push_back(std::vector<bool3S>(valor.begin(), valor.begin()+Nin));
+      if (R.cubos.size()>=MaxCubos) return true;
+      retroceder = true;
+    }
+    if (!retroceder)
+    {
+      unsigned i = 0;
+      bool3S vi = bool3S::FALSE;
+      bool achou = backtrace(N.getSaida(pendente), Alvo[pendente], i, vi);
+      // Sem caminho de sinais ?: uma entrada livre do cone de alguma saida pendente
+      for (unsigned j=0; j<Nout && !achou; j++)
+      {
+        if (Alvo[j]==bool3S::UNDEF || valor[N.getSaida(j)]!=bool3S::UNDEF) continue;
+        for (unsigned s : suporte[j])
+        {
+          if (valor[s]==bool3S::UNDEF)
+          {
+            i = s;
+            vi = bool3S::FALSE;
+            achou = true;
+            break;
+          }
+        }
+      }
+      if (achou)
+      {
+        pilha.push_back({i, false});
+        R.numDecisoes++;
+        atribuir(i, vi);
+        continue;
+      }
+    }
+
+    // Retrocesso: desfaz as decisoes jah trocadas e troca a ultima que ainda nao foi
+    while (!pilha.empty() && pilha.back().trocada)
+    {
+      atribuir(pilha.back().entrada, bool3S::UNDEF);
+      pilha.pop_back();
+    }
+    if (pilha.empty())
+    {
+      R.completa = true;
+      return true;
+    }
+    if (++R.numRetrocessos > MaxRetrocessos) return true;
+    pilha.back().trocada = true;
+    atribuir(pilha.back().entrada, ~valor[pilha.back().entrada]);
+  }
+}
+
+///
+/// Funcoes auxiliares
+///
+
+// Leh os alvos das saidas de um texto com restricoes "id=valor"
+bool lerAlvos(const std::string& Texto, unsigned Nout, std::vector<bool3S>& Alvo)
+{
+  std::string t = Texto;
+  std::replace(t.begin(), t.end(), ',', ' ');
+  std::istringstream I(t);
+  std::string restr;
+  Alvo.assign(Nout, bool3S::UNDEF);
+  while (I >> restr)
+  {
+    size_t igual = restr.find('=');
+    int id = 0;
+    std::istringstream L(restr.substr(0, igual));
+    if (igual==std::string::npos || !(L >> id) || !(L >> std::ws).eof() || id<=0 || unsigned(id)>Nout ||
+        restr.size()!=igual+2 || std::string("FfTt?").find(restr[igual+1])==std::string::npos)
+    {
+      std::cerr << "Alvo invalido: " << restr << "\n";
+      return false;
+    }
+    Alvo[id-1] = toBool3S(restr[igual+1]);
+  }
+  return true;
+}
+
+// Imprime os cubos, um por linha, no formato dos arquivos de estimulos
+std::ostream& operator<<(std::ostream& O, const ResultadoJustificacao& R)
+{
+  O << "# " << R.cubos.size() << " cubo(s), " << R.numDecisoes << " decisao(oes), "
+    << R.numRetrocessos << " retrocesso(s)" << (R.completa ? ", busca completa" : "") << '\n';
+  for (const std::vector<bool3S>& V : R.cubos)
+  {
+    for (unsigned i=0; i<V.size(); i++) O << V[i] << (i+1<V.size() ? ' ' : '\n');
+  }
+  return O;
+}
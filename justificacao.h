@@ -0,0 +1,95 @@
+#ifndef _JUSTIFICACAO_H_
+#define _JUSTIFICACAO_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// JUSTIFICACAO DE SAIDAS (busca de entradas no estilo PODEM)
+///
+
+// Procura vetores de entrada que levem as saidas do circuito aos valores pedidos, sem
+// percorrer a tabela verdade. As decisoes sao feitas apenas nas entradas do circuito:
+// - um objetivo (sinal, valor) eh escolhido em uma saida alvo que ainda vale ?;
+// - o objetivo eh levado para tras (backtrace) por sinais que valem ?, ateh uma entrada
+//   ainda livre, que recebe o valor correspondente;
+// - a decisao eh propagada (implicacao) com a logica de 3 estados de bool3S: as entradas
+//   livres valem ?, e uma porta soh muda de valor se as entradas definidas bastam;
+// - se alguma saida alvo fica com o valor errado, a ultima decisao nao trocada eh
+//   trocada (F <-> T) e as posteriores sao desfeitas (retrocesso).
+// Quando todas as saidas alvo tem o valor pedido, as entradas decididas formam um cubo:
+// como a logica de 3 estados eh monotona, qualquer valor nas entradas livres (?) do cubo
+// mantem as saidas alvo. Na busca de todos os cubos, a busca continua depois de cada
+// cubo; os cubos encontrados sao disjuntos e cobrem todos os vetores F/T que satisfazem
+// os alvos.
+//
+// Sem lacos, a implicacao eh feita por eventos, em ordem de nivel, apenas no cone das
+// entradas alteradas. Com lacos, o circuito inteiro eh simulado a cada decisao (para
+// recalcular o ponto fixo a partir de ?). Os flip-flops ficam com estado UNDEF.
+
+// Resultado de uma justificacao
+struct ResultadoJustificacao {
+  // Cubos encontrados: valores das entradas (? = livre)
+  std::vector<std::vector<bool3S>> cubos;
+  // A busca terminou (todos os cubos foram encontrados ou foi provado que nao ha
+  // nenhum), sem atingir o limite de cubos nem o de retrocessos
+  bool completa;
+  unsigned long long numDecisoes;
+  unsigned long long numRetrocessos;
+};
+
+class Justificador {
+private:
+  Netlist N;
+  // Valores atuais de todos os sinais
+  std::vector<bool3S> valor;
+  // Entradas do circuito das quais cada saida depende estruturalmente
+  std::vector<std::vector<unsigned>> suporte;
+  // Ha sinais que dependem de alguma entrada do circuito (para o backtrace)
+  std::vector<bool> controlavel;
+  // Fila de eventos por nivel (apenas sem lacos)
+  std::vector<std::vector<unsigned>> fila;
+  std::vector<bool> naFila;
+  std::vector<bool3S> entrPorta;
+  // Sinais para a simulacao completa (apenas com lacos)
+  std::vector<bool3S_64> sinais64;
+
+  // Calcula os valores de todos os sinais a partir das entradas
+  void simularTudo();
+  // Fixa o valor da entrada I e propaga
+  void atribuir(unsigned I, bool3S V);
+  // Leva o objetivo (sinal S, valor V) ateh uma entrada livre
+  // Retorna false se nao encontrar
+  bool backtrace(unsigned S, bool3S V, unsigned& I, bool3S& Vi) const;
+
+public:
+  Justificador() {}
+
+  // Compila o circuito
+  // Retorna false se o circuito nao for valido
+  bool inicializar(const Circuit& C);
+
+  unsigned getNumInputs() const {return N.getNumInputs();}
+  unsigned getNumOutputs() const {return N.getNumOutputs();}
+
+  // Procura ateh MaxCubos cubos de entrada que dao a cada saida j o valor Alvo[j]
+  // (Alvo[j]==UNDEF: saida sem restricao), com no maximo MaxRetrocessos retrocessos
+  // Retorna false se a dimensao de Alvo for invalida
+  bool justificar(const std::vector<bool3S>& Alvo, ResultadoJustificacao& R,
+                  unsigned long long MaxCubos=1, unsigned long long MaxRetrocessos=1000000);
+};
+
+// Leh os alvos das saidas de um texto com restricoes "id=valor" separadas por virgulas
+// ou espacos, por exemplo "1=T, 3=F"; as saidas nao citadas ficam sem restricao (UNDEF)
+// Retorna false (com uma mensagem em cerr) se o texto for invalido
+bool lerAlvos(const std::string& Texto, unsigned Nout, std::vector<bool3S>& Alvo);
+
+// Imprime os cubos, um por linha, no formato dos arquivos de estimulos
+std::ostream& operator<<(std::ostream& O, const ResultadoJustificacao& R);
+
+#endif // _JUSTIFICACAO_H_
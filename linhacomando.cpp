@@ -0,0 +1,500 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "linhacomando.h"
+#include "circuit.h"
+#include "importar.h"
+#include "estimulo.h"
+#include "tabela.h"
+#include "fluxo.h"
+#include "gerador.h"
+#include "equivalencia.h"
+#include "atividade.h"
+#include "justificacao.h"
+#include "mapeamento.h"
+#include "codigocpp.h"
+#include "reordenacao.h"
+#include "hierarquia.h"
+#include "servidor.h"
+#include "rastro.h"
+
+using namespace std;
+
+///
+/// Funcoes auxiliares
+///
+
+// Leh um circuito no formato do projeto ou, pela extensao, .bench/.blif
+// Um circuito hierarquico (ver hierarquia.h) eh achatado
+// Retorna false (com uma mensagem em cerr) se o arquivo ou o circuito for invalido
+static bool carregarCircuito(const string& Arq, Circuit& C)
+{
+  size_t ponto = Arq.rfind('.');
+  string ext = (ponto==string::npos) ? "" : Arq.substr(ponto);
+  bool ok;
+  if (ext==".bench" || ext==".blif") ok = importarCircuito(Arq, C);
+  else if (arquivoHierarquico(Arq))
+  {
+    CircuitoHierarquico H;
+    ok = H.ler(Arq) && H.achatar(C);
+  }
+  else ok = C.ler(Arq);
+  if (!ok || !C.valid())
+  {
+    cerr << "Arquivo " << Arq << " invalido para leitura\n";
+    return false;
+  }
+  return true;
+}
+
+// Abre o arquivo de saida (ou usa cout, se Arq for vazio ou "-") e chama Escrever
+// Retorna false (com uma mensagem em cerr) se deu erro na abertura ou na escrita
+template <class Funcao>
+static bool escreverSaida(const string& Arq, Funcao Escrever)
+{
+  if (Arq.empty() || Arq=="-")
+  {
+    Escrever(cout);
+    cout.flush();
+    return bool(cout);
+  }
+  ofstream O(Arq);
+  if (O.is_open()) Escrever(O);
+  if (!O.is_open() || !O)
+  {
+    cerr << "Arquivo " << Arq << " invalido para escrita\n";
+    return false;
+  }
+  return true;
+}
+
+// Converte o argumento A para um numero em X; retorna false se nao for um numero
+template <class T>
+static bool converterArg(const char* A, T& X)
+{
+  istringstream I(A);
+  return (I >> X) && (I >> ws).eof();
+}
+
+// Converte uma lista de pesos separados por virgulas, por exemplo "0.6,0.25,0.15"
+// Retorna false se a lista for vazia ou se algum peso nao for um numero nao negativo
+static bool converterPesos(const string& A, vector<double>& P)
+{
+  P.clear();
+  size_t inicio = 0;
+  while (true)
+  {
+    size_t virgula = A.find(',', inicio);
+    double x;
+    if (!converterArg(A.substr(inicio, virgula-inicio).c_str(), x) || x<0.0) return false;
+    P.push_back(x);
+    if (virgula==string::npos) return true;
+    inicio = virgula+1;
+  }
+}
+
+// Leh a opcao --fanin MIN:w0,w1,... do gerador (ver ParamGerador)
+static bool converterFanIn(const string& A, ParamGerador& P)
+{
+  size_t dois = A.find(':');
+  return dois!=string::npos && converterArg(A.substr(0, dois).c_str(), P.fanInMin) &&
+         converterPesos(A.substr(dois+1), P.pesosFanIn);
+}
+
+// Leh a opcao --tipos wNT,wAN,wNA,wOR,wNO,wXO,wNX do gerador (ver ParamGerador)
+static bool converterPesosTipo(const string& A, ParamGerador& P)
+{
+  vector<double> pesos;
+  if (!converterPesos(A, pesos) || pesos.size()!=NUM_TIPOS_GERADOR) return false;
+  for (unsigned i=0; i<NUM_TIPOS_GERADOR; i++) P.pesosTipo[i] = pesos[i];
+  return true;
+}
+
+static void imprimirUso(ostream& O)
+{
+  O << "Uso: circuito [SUBCOMANDO ARGUMENTOS...]\n"
+    << "Sem argumentos, abre o menu interativo. Subcomandos:\n"
+    << "  validar ARQ\n"
+    << "  simular ARQ ESTIMULOS [SAIDA]\n"
+    << "  tabela ARQ [SAIDA]\n"
+    << "  tabela2 ARQ [SAIDA]\n"
+    << "  restrita ARQ RESTRICOES [SAIDA]\n"
+    << "  resumo ARQ [SAIDA]\n"
+    << "  converter ENTRADA SAIDA\n"
+    << "  estat ARQ [ESTIMULOS]\n"
+    << "  gerar SAIDA Nin Nout Nportas Prof [ForaOrdem Realimentacao Semente]\n"
+    << "        [--fanin MIN:w0,w1,...] [--tipos wNT,wAN,wNA,wOR,wNO,wXO,wNX]\n"
+    << "  equivalencia A B [auto|exaustiva|vetores]\n"
+    << "  atividade ARQ [AMOSTRAS [PROBABILIDADES]]\n"
+    << "  justificar ARQ ALVOS [MAXCUBOS]\n"
+    << "  codigo ARQ NOME [SAIDA]\n"
+    << "  mapear ARQ [K [ESTIMULOS]]\n"
+    << "  reordenar ARQ [SAIDA]\n"
+    << "  achatar ARQ [SAIDA]\n"
+    << "  servidor SOCKET NOME=ARQ...\n"
+    << "  ajuda\n"
+    << "Circuitos .bench e .blif sao importados e circuitos hierarquicos (SUBCIRCUITO)\n"
+    << "sao achatados, exceto em simular; SAIDA \"-\" eh a saida padrao.\n";
+}
+
+///
+/// Subcomandos (Arg[0] eh o primeiro argumento depois do subcomando)
+///
+
+static int cmdValidar(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  cout << C.getNumInputs() << " entrada(s), " << C.getNumOutputs() << " saida(s), "
+       << C.getNumPorts() << " porta(s)\n";
+  return SAIDA_OK;
+}
+
+static int cmdSimular(const vector<string>& Arg)
+{
+  // Um circuito hierarquico eh simulado sem ser achatado (ver hierarquia.h)
+  const bool hierarquico = arquivoHierarquico(Arg[0]);
+  Circuit C;
+  CircuitoHierarquico H;
+  if (hierarquico ? !H.ler(Arg[0]) : !carregarCircuito(Arg[0], C))
+  {
+    if (hierarquico) cerr << "Arquivo " << Arg[0] << " invalido para leitura\n";
+    return SAIDA_ERRO;
+  }
+  // Os estimulos sao lidos e simulados em fluxo (ver fluxo.h), sem carregar o arquivo
+  istream* I = &cin;
+  ifstream arquivo;
+  if (Arg[1]!="-")
+  {
+    arquivo.open(Arg[1]);
+    if (!arquivo.is_open())
+    {
+      cerr << "Arquivo " << Arg[1] << " invalido para leitura\n";
+      return SAIDA_ERRO;
+    }
+    I = &arquivo;
+  }
+  bool ok = true;
+  bool escrito = escreverSaida(Arg.size()>2 ? Arg[2] : "", [&](ostream& O)
+  {
+    ok = hierarquico ? H.simularEstimulos(*I, O) : simularFluxo(C, *I, O);
+  });
+  return (ok && escrito) ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdTabela(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  bool ok = escreverSaida(Arg.size()>1 ? Arg[1] : "", [&](ostream& O) {gerarTabela(C, O);});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdTabelaBinaria(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  bool ok = true;
+  bool escrito = escreverSaida(Arg.size()>1 ? Arg[1] : "", [&](ostream& O) {ok = gerarTabelaBinaria(C, O);});
+  return (ok && escrito) ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdTabelaRestrita(const vector<string>& Arg)
+{
+  Circuit C;
+  vector<DominioEntrada> D;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  if (!lerDominios(Arg[1], C.getNumInputs(), D)) return SAIDA_USO;
+  bool ok = true;
+  bool escrito = escreverSaida(Arg.size()>2 ? Arg[2] : "", [&](ostream& O) {ok = gerarTabelaRestrita(C, D, O);});
+  return (ok && escrito) ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdJustificar(const vector<string>& Arg)
+{
+  Circuit C;
+  Justificador J;
+  vector<bool3S> Alvo;
+  ResultadoJustificacao R;
+  unsigned long long MaxCubos = 1;
+  if (Arg.size()>2 && (!converterArg(Arg[2].c_str(), MaxCubos) || MaxCubos==0))
+  {
+    cerr << "Numero maximo de cubos invalido: " << Arg[2] << "\n";
+    return SAIDA_USO;
+  }
+  if (!carregarCircuito(Arg[0], C) || !J.inicializar(C)) return SAIDA_ERRO;
+  if (!lerAlvos(Arg[1], J.getNumOutputs(), Alvo)) return SAIDA_USO;
+  if (!J.justificar(Alvo, R, MaxCubos)) return SAIDA_ERRO;
+  cout << R;
+  return R.cubos.empty() ? SAIDA_ERRO : SAIDA_OK;
+}
+
+static int cmdCodigo(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  bool ok = true;
+  bool escrito = escreverSaida(Arg.size()>2 ? Arg[2] : "", [&](ostream& O) {ok = gerarCodigoCpp(C, Arg[1], O);});
+  return (ok && escrito) ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdMapear(const vector<string>& Arg)
+{
+  Circuit C;
+  RedeLUT R;
+  unsigned K = MAX_K_LUT;
+  if (Arg.size()>1 && (!converterArg(Arg[1].c_str(), K) || K<1 || K>MAX_K_LUT))
+  {
+    cerr << "K deve estar entre 1 e " << MAX_K_LUT << ": " << Arg[1] << "\n";
+    return SAIDA_USO;
+  }
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  // A rede eh conferida com o circuito original antes de ser usada
+  if (!R.mapear(C, K) || !R.conferir(C)) return SAIDA_ERRO;
+  if (Arg.size()<3)
+  {
+    cout << R;
+    return SAIDA_OK;
+  }
+  // Com estimulos, o resumo vai para cerr e a saida padrao recebe apenas as linhas
+  cerr << R;
+  istream* I = &cin;
+  ifstream arquivo;
+  if (Arg[2]!="-")
+  {
+    arquivo.open(Arg[2]);
+    if (!arquivo.is_open())
+    {
+      cerr << "Arquivo " << Arg[2] << " invalido para leitura\n";
+      return SAIDA_ERRO;
+    }
+    I = &arquivo;
+  }
+  bool ok = true;
+  bool escrito = escreverSaida("", [&](ostream& O) {ok = R.simularEstimulos(*I, O);});
+  return (ok && escrito) ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdReordenar(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  if (!reordenarPortas(C)) return SAIDA_ERRO;
+  bool ok = escreverSaida(Arg.size()>1 ? Arg[1] : "", [&](ostream& O) {C.imprimir(O);});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdAchatar(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  bool ok = escreverSaida(Arg.size()>1 ? Arg[1] : "", [&](ostream& O) {C.imprimir(O);});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdResumo(const vector<string>& Arg)
+{
+  Circuit C;
+  ResumoTabela R;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  if (!resumirTabela(C, R)) return SAIDA_ERRO;
+  bool ok = escreverSaida(Arg.size()>1 ? Arg[1] : "", [&](ostream& O) {O << R;});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdConverter(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  bool ok = escreverSaida(Arg[1], [&](ostream& O) {C.imprimir(O);});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdEstat(const vector<string>& Arg)
+{
+  Circuit C;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  if (Arg.size()>1)
+  {
+    vector<vector<bool3S>> vetores;
+    if (!lerEstimulos(Arg[1], C.getNumInputs(), vetores))
+    {
+      cerr << "Arquivo " << Arg[1] << " invalido para leitura\n";
+      return SAIDA_ERRO;
+    }
+    for (const vector<bool3S>& in_circ : vetores) C.simular(in_circ);
+  }
+  else
+  {
+    // Sem estimulos, simula a tabela verdade (descartando a impressao)
+    ostream nulo(nullptr);
+    gerarTabela(C, nulo);
+  }
+  C.imprimirEstatisticas(cout);
+  return SAIDA_OK;
+}
+
+static int cmdGerar(const vector<string>& A)
+{
+  ParamGerador P;
+  const char* nomes[] = {"Nin", "Nout", "Nportas", "Prof", "ForaOrdem", "Realimentacao", "Semente"};
+  // As opcoes --fanin e --tipos podem vir em qualquer posicao; o resto sao os argumentos
+  // posicionais (SAIDA Nin Nout Nportas Prof [ForaOrdem Realimentacao Semente])
+  vector<string> Arg;
+  for (unsigned k=0; k<A.size(); k++)
+  {
+    if (A[k]!="--fanin" && A[k]!="--tipos")
+    {
+      Arg.push_back(A[k]);
+      continue;
+    }
+    if (k+1>=A.size() || !(A[k]=="--fanin" ? converterFanIn(A[k+1], P) : converterPesosTipo(A[k+1], P)))
+    {
+      cerr << "Valor invalido para " << A[k] << ": " << (k+1<A.size() ? A[k+1] : "") << '\n';
+      return SAIDA_USO;
+    }
+    k++;
+  }
+  if (Arg.size()<5 || Arg.size()>8)
+  {
+    cerr << "Numero de argumentos invalido para gerar\n";
+    imprimirUso(cerr);
+    return SAIDA_USO;
+  }
+  bool ok = converterArg(Arg[1].c_str(), P.Nin) && converterArg(Arg[2].c_str(), P.Nout) &&
+            converterArg(Arg[3].c_str(), P.Nportas) && converterArg(Arg[4].c_str(), P.profundidade);
+  if (ok && Arg.size()>5) ok = converterArg(Arg[5].c_str(), P.fracForaOrdem);
+  if (ok && Arg.size()>6) ok = converterArg(Arg[6].c_str(), P.fracRealimentacao);
+  if (ok && Arg.size()>7) ok = converterArg(Arg[7].c_str(), P.semente);
+  if (!ok || !P.valid())
+  {
+    cerr << "Parametros invalidos para o gerador:";
+    for (unsigned k=1; k<Arg.size(); k++) cerr << ' ' << nomes[k-1] << '=' << Arg[k];
+    cerr << " fanin=" << P.fanInMin << ':';
+    for (unsigned k=0; k<P.pesosFanIn.size(); k++) cerr << (k>0 ? "," : "") << P.pesosFanIn[k];
+    cerr << " tipos=";
+    for (unsigned i=0; i<NUM_TIPOS_GERADOR; i++) cerr << (i>0 ? "," : "") << P.pesosTipo[i];
+    cerr << '\n';
+    return SAIDA_USO;
+  }
+  ok = escreverSaida(Arg[0], [&](ostream& O) {gerarCircuito(P, O);});
+  return ok ? SAIDA_OK : SAIDA_ERRO;
+}
+
+static int cmdEquivalencia(const vector<string>& Arg)
+{
+  Circuit A, B;
+  ResultadoEquivalencia R;
+  ModoEquivalencia Modo = ModoEquivalencia::AUTOMATICO;
+  if (Arg.size()>2)
+  {
+    if (Arg[2]=="exaustiva") Modo = ModoEquivalencia::EXAUSTIVO;
+    else if (Arg[2]=="vetores") Modo = ModoEquivalencia::VETORES;
+    else if (Arg[2]!="auto")
+    {
+      cerr << "Modo de verificacao invalido (auto, exaustiva ou vetores): " << Arg[2] << "\n";
+      return SAIDA_USO;
+    }
+  }
+  if (!carregarCircuito(Arg[0], A) || !carregarCircuito(Arg[1], B)) return SAIDA_ERRO;
+  // Automatico: todos os vetores se couber no orcamento; senao, casos extremos e vetores aleatorios
+  if (!verificarEquivalenciaModo(A, B, R, Modo)) return SAIDA_ERRO;
+  cout << R;
+  return R.equivalentes ? SAIDA_OK : SAIDA_DIFERENTES;
+}
+
+static int cmdAtividade(const vector<string>& Arg)
+{
+  Circuit C;
+  ParamAtividade P;
+  ResultadoAtividade R;
+  if (!carregarCircuito(Arg[0], C)) return SAIDA_ERRO;
+  if (Arg.size()>1 && !converterArg(Arg[1].c_str(), P.maxAmostras))
+  {
+    cerr << "Numero de amostras invalido: " << Arg[1] << '\n';
+    return SAIDA_USO;
+  }
+  if (Arg.size()>2 && !P.lerProbabilidades(Arg[2], C.getNumInputs())) return SAIDA_ERRO;
+  if (!estimarAtividade(C, P, R)) return SAIDA_ERRO;
+  cout << R;
+  return SAIDA_OK;
+}
+
+static int cmdServidor(const vector<string>& Arg)
+{
+  ServidorSimulacao S;
+  for (unsigned k=1; k<Arg.size(); k++)
+  {
+    size_t igual = Arg[k].find('=');
+    if (igual==string::npos || igual==0)
+    {
+      cerr << "Argumento invalido (esperado NOME=ARQ): " << Arg[k] << '\n';
+      return SAIDA_USO;
+    }
+    if (!S.carregar(Arg[k].substr(0, igual), Arg[k].substr(igual+1))) return SAIDA_ERRO;
+  }
+  if (!S.iniciar(Arg[0])) return SAIDA_ERRO;
+  cerr << "Servidor em " << Arg[0] << " com " << S.getNumCircuitos() << " circuito(s)\n";
+  S.executar();
+  cerr << S.getNumPedidos() << " pedido(s) SIMULAR em " << S.getNumLotes() << " lote(s)\n";
+  return SAIDA_OK;
+}
+
+///
+/// Despacho dos subcomandos
+///
+
+struct Subcomando {
+  const char* nome;
+  // Numero minimo e maximo de argumentos depois do subcomando
+  unsigned minArgs, maxArgs;
+  int (*executar)(const vector<string>& Arg);
+};
+
+static const Subcomando subcomandos[] = {
+  {"validar", 1, 1, cmdValidar},
+  {"simular", 2, 3, cmdSimular},
+  {"tabela", 1, 2, cmdTabela},
+  {"tabela2", 1, 2, cmdTabelaBinaria},
+  {"restrita", 2, 3, cmdTabelaRestrita},
+  {"resumo", 1, 2, cmdResumo},
+  {"converter", 2, 2, cmdConverter},
+  {"estat", 1, 2, cmdEstat},
+  {"gerar", 5, 12, cmdGerar},
+  {"equivalencia", 2, 3, cmdEquivalencia},
+  {"atividade", 1, 3, cmdAtividade},
+  {"justificar", 2, 3, cmdJustificar},
+  {"codigo", 2, 3, cmdCodigo},
+  {"mapear", 1, 3, cmdMapear},
+  {"reordenar", 1, 2, cmdReordenar},
+  {"achatar", 1, 2, cmdAchatar},
+  {"servidor", 2, ~0u, cmdServidor},
+};
+
+int executarLinhaComando(int argc, char* argv[])
+{
+  if (argc<2) return SAIDA_USO;
+  string nome = argv[1];
+  vector<string> arg(argv+2, argv+argc);
+  if (nome=="ajuda" || nome=="-h" || nome=="--help")
+  {
+    imprimirUso(cout);
+    return SAIDA_OK;
+  }
+  for (const Subcomando& S : subcomandos)
+  {
+    if (nome!=S.nome) continue;
+    if (arg.size()<S.minArgs || arg.size()>S.maxArgs)
+    {
+      cerr << "Numero de argumentos invalido para " << nome << "\n";
+      imprimirUso(cerr);
+      return SAIDA_USO;
+    }
+    return S.executar(arg);
+  }
+  cerr << "Subcomando desconhecido: " << nome << "\n";
+  imprimirUso(cerr);
+  return SAIDA_USO;
+}
@@ -0,0 +1,72 @@
+#ifndef _LINHACOMANDO_H_
+#define _LINHACOMANDO_H_
+
+///
+/// INTERFACE DE LINHA DE COMANDO (sem menu interativo)
+///
+
+// Quando o programa eh chamado com argumentos, o primeiro eh um subcomando:
+//   validar ARQ                       confere o circuito e imprime as suas dimensoes
+//   simular ARQ ESTIMULOS [SAIDA]     simula cada vetor do arquivo de estimulos ("-": entrada
+//                                     padrao) e imprime uma linha "entradas TAB saidas" por
+//                                     vetor, na ordem dos estimulos (ver fluxo.h)
+//                                     Um circuito hierarquico eh simulado sem ser achatado
+//   tabela ARQ [SAIDA]                gera a tabela verdade
+//   tabela2 ARQ [SAIDA]               gera a tabela verdade apenas com entradas F e T
+//   restrita ARQ RESTRICOES [SAIDA]   gera a tabela verdade com os valores das entradas
+//                                     restritos, por exemplo "-1=T,-3=T,-2=FT" (ver tabela.h)
+//   resumo ARQ [SAIDA]                resume a tabela verdade sem imprimir as linhas
+//                                     (contagens, saidas constantes e dependencias)
+//   converter ENTRADA SAIDA           leh o circuito e o salva no formato do projeto
+//   estat ARQ [ESTIMULOS]             simula os estimulos (ou a tabela verdade) e imprime
+//                                     as estatisticas de simulacao
+//   gerar SAIDA Nin Nout Nportas Prof [ForaOrdem Realimentacao Semente]
+//         [--fanin MIN:w0,w1,...] [--tipos wNT,wAN,wNA,wOR,wNO,wXO,wNX]
+//                                     gera um circuito sintetico (ver gerador.h); --fanin
+//                                     da o numero minimo de entradas das portas e os pesos
+//                                     de MIN, MIN+1, ... entradas; --tipos, os pesos de cada
+//                                     tipo de porta
+//   equivalencia A B [MODO]           verifica a equivalencia entre dois circuitos; MODO eh
+//                                     auto (padrao: exaustiva se couber no orcamento de
+//                                     trabalho), exaustiva ou vetores (ver equivalencia.h)
+//   atividade ARQ [AMOSTRAS [PROB]]   estima as probabilidades e a taxa de troca de cada
+//                                     porta; PROB tem uma linha "probT [probU]" por entrada
+//                                     (ver atividade.h)
+//   justificar ARQ ALVOS [MAXCUBOS]   procura vetores de entrada que dao as saidas os valores
+//                                     pedidos, por exemplo "1=T,3=F", e os imprime como cubos
+//                                     no formato dos estimulos (ver justificacao.h); retorna
+//                                     SAIDA_ERRO se nao houver nenhum
+//   codigo ARQ NOME [SAIDA]           gera um cabecalho C++ que avalia o circuito com codigo
+//                                     em linha reta, no namespace NOME (ver codigocpp.h)
+//   mapear ARQ [K [ESTIMULOS]]        mapeia o circuito em LUTs de ateh K entradas (padrao 6),
+//                                     confere a rede com o circuito e imprime o numero de
+//                                     nos; com ESTIMULOS ("-": entrada padrao), simula cada
+//                                     vetor pela rede e imprime as linhas como simular, com
+//                                     o resumo em cerr (ver mapeamento.h)
+//   reordenar ARQ [SAIDA]             renumera as portas por nivel e vizinhanca, para a
+//                                     localidade de memoria, e salva o circuito (ver
+//                                     reordenacao.h)
+//   achatar ARQ [SAIDA]               achata um circuito hierarquico (ver hierarquia.h) e o
+//                                     salva no formato do projeto
+//   servidor SOCKET NOME=ARQ...       executa o servidor de simulacao (ver servidor.h)
+//   ajuda                             imprime esta lista
+// Os circuitos (ARQ, ENTRADA, A, B) estao no formato do projeto ou, pela extensao do
+// arquivo, nos formatos .bench e .blif; um circuito hierarquico (ver hierarquia.h) eh
+// achatado, exceto no subcomando simular. Se SAIDA for omitida ou for "-", o resultado vai
+// para a saida padrao. As mensagens de diagnostico vao sempre para cerr, de modo que a
+// saida padrao pode ser usada em pipes.
+
+// Codigos de retorno do programa
+const int SAIDA_OK = 0;
+// Circuito ou arquivo invalido (leitura, validacao ou escrita)
+const int SAIDA_ERRO = 1;
+// Subcomando ou argumentos invalidos
+const int SAIDA_USO = 2;
+// Circuitos diferentes (subcomando equivalencia)
+const int SAIDA_DIFERENTES = 3;
+
+// Executa o subcomando em argv[1] com os argumentos seguintes
+// Retorna o codigo de retorno do programa
+int executarLinhaComando(int argc, char* argv[]);
+
+#endif // _LINHACOMANDO_H_
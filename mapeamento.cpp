@@ -0,0 +1,481 @@
+#include <algorithm>
+#include "mapeamento.h"
+#include "bool3S_64.h"
+#include "estimulo.h"
+#include "rastro.h"
+
+// Numero maximo de cortes parciais mantidos ao combinar as entradas de uma porta
+static const unsigned MAX_CORTES_PARCIAIS = 4*MAX_CORTES_LUT;
+
+// Um corte: ateh MAX_K_LUT folhas (indices de sinal da netlist), em ordem crescente
+struct CorteLUT {
+  unsigned n;
+  unsigned folha[MAX_K_LUT];
+  // Fluxo de area (custo) do corte
+  double fluxo;
+};
+
+static bool operator<(const CorteLUT& A, const CorteLUT& B)
+{
+  return std::lexicographical_compare(A.folha, A.folha+A.n, B.folha, B.folha+B.n);
+}
+
+static bool operator==(const CorteLUT& A, const CorteLUT& B)
+{
+  return A.n==B.n && std::equal(A.folha, A.folha+A.n, B.folha);
+}
+
+// Uniao de dois cortes (folhas em ordem crescente)
+// Retorna false se a uniao tiver mais de K folhas
+static bool unir(const CorteLUT& A, const CorteLUT& B, unsigned K, CorteLUT& U)
+{
+  unsigned a = 0, b = 0;
+  U.n = 0;
+  while (a<A.n || b<B.n)
+  {
+    unsigned x;
+    if (b==B.n || (a<A.n && A.folha[a]<B.folha[b])) x = A.folha[a++];
+    else if (a==A.n || B.folha[b]<A.folha[a]) x = B.folha[b++];
+    else {x = A.folha[a++]; b++;}
+    if (U.n==K) return false;
+    U.folha[U.n++] = x;
+  }
+  return true;
+}
+
+// Mantem os Max melhores cortes distintos (menor custo; em caso de empate, menos folhas)
+static void podar(std::vector<CorteLUT>& V, unsigned Max)
+{
+  std::sort(V.begin(), V.end());
+  V.erase(std::unique(V.begin(), V.end()), V.end());
+  std::stable_sort(V.begin(), V.end(), [](const CorteLUT& A, const CorteLUT& B)
+  {
+    return A.fluxo<B.fluxo || (A.fluxo==B.fluxo && A.n<B.n);
+  });
+  if (V.size()>Max) V.resize(Max);
+}
+
+///
+/// CLASSE REDELUT
+///
+
+RedeLUT::RedeLUT(): Nin(0), numPortas(0), inicioLaco(0) {}
+
+// Esvazia a rede
+void RedeLUT::clear()
+{
+  Nin = numPortas = inicioLaco = 0;
+  inicioFolhas.clear();
+  folhas.clear();
+  inicioTabela.clear();
+  tabela.clear();
+  tipo.clear();
+  saidas.clear();
+}
+
+// Mapeia o circuito C em LUTs de ateh K entradas
+bool RedeLUT::mapear(const Circuit& C, unsigned K)
+{
+  RASTRO_ESCOPO("mapear LUTs");
+  clear();
+  if (K<1 || K>MAX_K_LUT)
+  {
+    std::cerr << "Numero de entradas de LUT invalido: " << K << "\n";
+    return false;
+  }
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    std::cerr << "Circuito invalido para mapeamento\n";
+    return false;
+  }
+  if (!N.getFlipFlops().empty())
+  {
+    std::cerr << "Circuitos com flip-flops nao sao mapeados\n";
+    return false;
+  }
+  const unsigned NinC = N.getNumInputs();
+  const unsigned NP = N.getNumPorts();
+  const unsigned NS = N.getNumSinais();
+  const std::vector<unsigned>& ordem = N.getOrdem();
+  const unsigned laco = N.getInicioLaco();
+
+  // Corte com as entradas distintas da porta P; retorna false se forem mais de K
+  auto entradasDistintas = [&](unsigned P, CorteLUT& X) -> bool
+  {
+    X.n = 0;
+    const unsigned* e = N.getEntradas(P);
+    for (unsigned k=0; k<N.getNumInputsPort(P); k++)
+    {
+      CorteLUT t, u;
+      t.n = 1;
+      t.folha[0] = e[k];
+      if (!unir(X, t, K, u)) return false;
+      X = u;
+    }
+    return true;
+  };
+
+  // Custo dos sinais: 0 para as entradas do circuito; para uma porta, o do seu melhor corte
+  std::vector<double> fluxo(NS, 0.0);
+  auto custo = [&](CorteLUT& X)
+  {
+    X.fluxo = 1.0;
+    for (unsigned k=0; k<X.n; k++) X.fluxo += fluxo[X.folha[k]]/std::max(1u, N.getNumFanout(X.folha[k]));
+  };
+
+  /// Enumeracao dos cortes (sem o corte trivial de cada sinal)
+  std::vector<std::vector<CorteLUT>> cortes(NS);
+  {
+    RASTRO_ESCOPO("mapear LUTs: cortes");
+    std::vector<CorteLUT> atual, prox;
+    for (unsigned i=0; i<NP; i++)
+    {
+      unsigned P = ordem[i];
+      unsigned S = NinC+P;
+      CorteLUT propria;
+      bool cabe = entradasDistintas(P, propria);
+      if (i>=laco || !cabe)
+      {
+        // Porta em laco ou com entradas demais: fica sozinha no seu no
+        fluxo[S] = 1.0;
+        const unsigned* e = N.getEntradas(P);
+        for (unsigned k=0; k<N.getNumInputsPort(P); k++) fluxo[S] += fluxo[e[k]]/std::max(1u, N.getNumFanout(e[k]));
+        continue;
+      }
+      // Combina os cortes de cada entrada (incluindo o corte trivial da entrada)
+      atual.assign(1, CorteLUT());
+      atual[0].n = 0;
+      for (unsigned k=0; k<propria.n; k++)
+      {
+        unsigned f = propria.folha[k];
+        CorteLUT trivial, u;
+        trivial.n = 1;
+        trivial.folha[0] = f;
+        prox.clear();
+        for (const CorteLUT& c : atual)
+        {
+          if (unir(c, trivial, K, u)) prox.push_back(u);
+          for (const CorteLUT& d : cortes[f])
+          {
+            if (unir(c, d, K, u)) prox.push_back(u);
+          }
+        }
+        for (CorteLUT& c : prox) custo(c);
+        podar(prox, MAX_CORTES_PARCIAIS);
+        atual.swap(prox);
+      }
+      // O corte com as proprias entradas sempre cabe
+      atual.push_back(propria);
+      for (CorteLUT& c : atual) custo(c);
+      podar(atual, MAX_CORTES_LUT);
+      cortes[S] = atual;
+      fluxo[S] = atual[0].fluxo;
+    }
+  }
+
+  /// Cobertura: a partir das saidas, cada sinal necessario usa o seu melhor corte
+  std::vector<bool> necessario(NS, false);
+  std::vector<unsigned> pilha;
+  for (unsigned j=0; j<N.getNumOutputs(); j++) pilha.push_back(N.getSaida(j));
+  while (!pilha.empty())
+  {
+    unsigned S = pilha.back();
+    pilha.pop_back();
+    if (S<NinC || necessario[S]) continue;
+    necessario[S] = true;
+    if (!cortes[S].empty())
+    {
+      const CorteLUT& c = cortes[S][0];
+      pilha.insert(pilha.end(), c.folha, c.folha+c.n);
+    }
+    else
+    {
+      const unsigned* e = N.getEntradas(S-NinC);
+      pilha.insert(pilha.end(), e, e+N.getNumInputsPort(S-NinC));
+    }
+  }
+
+  // Numeracao dos nos, na ordem de avaliacao
+  std::vector<unsigned> no(NS, ~0u);
+  std::vector<unsigned> posicao(NP);
+  unsigned numNos = 0;
+  Nin = NinC;
+  numPortas = NP;
+  for (unsigned i=0; i<NP; i++)
+  {
+    posicao[ordem[i]] = i;
+    if (i==laco) inicioLaco = numNos;
+    if (necessario[NinC+ordem[i]]) no[NinC+ordem[i]] = numNos++;
+  }
+  if (laco==NP) inicioLaco = numNos;
+  auto sinalRede = [&](unsigned S) {return (S<NinC) ? S : NinC+no[S];};
+
+  /// Construcao dos nos e calculo das tabelas
+  RASTRO_ESCOPO("mapear LUTs: tabelas");
+  // Valores das folhas para todas as combinacoes: padrao[m][w*m+k] eh a palavra w da folha k
+  // (a combinacao 64*w+pista tem o digito k, na base 3, igual ao valor da folha k)
+  std::vector<std::vector<bool3S_64>> padrao(K+1);
+  std::vector<bool3S_64> valores(NS, bool3S_64{0,0});
+  std::vector<unsigned> marca(NS, ~0u);
+  std::vector<unsigned> cone;
+  inicioFolhas.assign(1, 0);
+  inicioTabela.resize(numNos);
+  tipo.resize(numNos);
+  for (unsigned i=0; i<NP; i++)
+  {
+    unsigned P = ordem[i];
+    unsigned S = NinC+P;
+    if (!necessario[S]) continue;
+    unsigned k = no[S];
+    tipo[k] = N.getTipo(P);
+    CorteLUT c;
+    bool lut = !cortes[S].empty();
+    if (lut) c = cortes[S][0];
+    else lut = entradasDistintas(P, c);
+    if (!lut)
+    {
+      // Porta com entradas demais: avaliada como porta
+      const unsigned* e = N.getEntradas(P);
+      for (unsigned j=0; j<N.getNumInputsPort(P); j++) folhas.push_back(sinalRede(e[j]));
+      inicioFolhas.push_back(folhas.size());
+      inicioTabela[k] = ~0u;
+      continue;
+    }
+    for (unsigned j=0; j<c.n; j++) folhas.push_back(sinalRede(c.folha[j]));
+    inicioFolhas.push_back(folhas.size());
+
+    // Portas do cone (entre as folhas e a raiz), na ordem de avaliacao
+    for (unsigned j=0; j<c.n; j++) marca[c.folha[j]] = k;
+    cone.clear();
+    pilha.assign(1, S);
+    marca[S] = k;
+    while (!pilha.empty())
+    {
+      unsigned X = pilha.back();
+      pilha.pop_back();
+      cone.push_back(X-NinC);
+      const unsigned* e = N.getEntradas(X-NinC);
+      for (unsigned j=0; j<N.getNumInputsPort(X-NinC); j++)
+      {
+        if (marca[e[j]]==k) continue;
+        marca[e[j]] = k;
+        pilha.push_back(e[j]);
+      }
+    }
+    std::sort(cone.begin(), cone.end(), [&](unsigned A, unsigned B) {return posicao[A]<posicao[B];});
+
+    // Simula o cone para todas as combinacoes das folhas
+    const unsigned m = c.n;
+    unsigned combinacoes = 1;
+    for (unsigned j=0; j<m; j++) combinacoes *= 3;
+    const unsigned palavras = (combinacoes+63)/64;
+    if (padrao[m].empty())
+    {
+      padrao[m].assign(size_t(palavras)*m, bool3S_64{0,0});
+      for (unsigned a=0; a<combinacoes; a++)
+      {
+        unsigned d = a;
+        for (unsigned j=0; j<m; j++, d/=3) fixarPista(padrao[m][(a/64)*m+j], a%64, bool3S(d%3));
+      }
+    }
+    inicioTabela[k] = tabela.size();
+    tabela.resize(tabela.size()+(2*combinacoes+63)/64, 0);
+    uint64_t* t = tabela.data()+inicioTabela[k];
+    for (unsigned w=0; w<palavras; w++)
+    {
+      for (unsigned j=0; j<m; j++) valores[c.folha[j]] = padrao[m][w*m+j];
+      for (unsigned Q : cone) valores[NinC+Q] = N.avaliar(Q, valores.data());
+      for (unsigned a=64*w; a<combinacoes && a<64*w+64; a++)
+      {
+        t[a/32] |= uint64_t(lerPista(valores[S], a%64)) << (2*(a%32));
+      }
+    }
+  }
+  for (unsigned j=0; j<N.getNumOutputs(); j++) saidas.push_back(sinalRede(N.getSaida(j)));
+  return true;
+}
+
+// Numero de nos que sao LUTs
+unsigned RedeLUT::getNumLUTs() const
+{
+  return getNumNos()-std::count(inicioTabela.begin(), inicioTabela.end(), ~0u);
+}
+
+// Calcula a saida do no K a partir dos valores atuais dos sinais
+inline bool3S RedeLUT::avaliar(unsigned K, const bool3S* Sinais) const
+{
+  const unsigned* f = folhas.data()+inicioFolhas[K];
+  const unsigned* fim = folhas.data()+inicioFolhas[K+1];
+  if (inicioTabela[K]!=~0u)
+  {
+    unsigned indice = 0;
+    while (fim>f) indice = 3*indice + unsigned(Sinais[*--fim]);
+    const uint64_t* t = tabela.data()+inicioTabela[K];
+    return bool3S((t[indice/32] >> (2*(indice%32))) & 3);
+  }
+  return avaliarPorta(tipo[K], f, unsigned(fim-f), Sinais);
+}
+
+// Simula a rede para um vetor de entradas
+void RedeLUT::simular(bool3S* Sinais) const
+{
+  const unsigned NN = getNumNos();
+  // Parte sem lacos: uma unica passada
+  for (unsigned k=0; k<inicioLaco; k++) Sinais[Nin+k] = avaliar(k, Sinais);
+  if (inicioLaco==NN) return;
+
+  // Parte com lacos: parte de UNDEF e reavalia ateh o ponto fixo
+  for (unsigned k=inicioLaco; k<NN; k++) Sinais[Nin+k] = bool3S::UNDEF;
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned k=inicioLaco; k<NN; k++)
+    {
+      bool3S v = avaliar(k, Sinais);
+      if (v!=Sinais[Nin+k])
+      {
+        Sinais[Nin+k] = v;
+        mudou = true;
+      }
+    }
+  } while (mudou);
+}
+
+// Simula a rede para um vetor de entradas e retorna as saidas do circuito
+bool RedeLUT::simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const
+{
+  if (in_circ.size()!=Nin || saidas.empty()) return false;
+  std::vector<bool3S> S(getNumSinais(), bool3S::UNDEF);
+  std::copy(in_circ.begin(), in_circ.end(), S.begin());
+  simular(S.data());
+  out_circ.resize(saidas.size());
+  for (unsigned j=0; j<saidas.size(); j++) out_circ[j] = S[saidas[j]];
+  return true;
+}
+
+// Simula pela rede os estimulos da stream I
+bool RedeLUT::simularEstimulos(std::istream& I, std::ostream& O) const
+{
+  RASTRO_ESCOPO("simular estimulos (LUTs)");
+  if (saidas.empty())
+  {
+    std::cerr << "Rede de LUTs vazia\n";
+    return false;
+  }
+  std::vector<bool3S> S(getNumSinais(), bool3S::UNDEF), V;
+  std::string linha;
+  while (lerEstimulo(I, Nin, V))
+  {
+    std::copy(V.begin(), V.end(), S.begin());
+    simular(S.data());
+    linha.clear();
+    for (unsigned i=0; i<Nin; i++)
+    {
+      linha += toChar(V[i]);
+      linha += (i+1<Nin) ? ' ' : '\t';
+    }
+    for (unsigned j=0; j<saidas.size(); j++)
+    {
+      linha += toChar(S[saidas[j]]);
+      linha += (j+1<saidas.size()) ? ' ' : '\n';
+    }
+    O << linha;
+  }
+  O.flush();
+  if (!O)
+  {
+    std::cerr << "Erro na escrita da saida da simulacao\n";
+    return false;
+  }
+  return !I.bad();
+}
+
+// Gerador pseudoaleatorio splitmix64 (estado S)
+static uint64_t proximoAleat(uint64_t& S)
+{
+  uint64_t X = (S += 0x9E3779B97F4A7C15ULL);
+  X = (X ^ (X >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  X = (X ^ (X >> 27)) * 0x94D049BB133111EBULL;
+  return X ^ (X >> 31);
+}
+
+// Confere a rede com o circuito original C
+bool RedeLUT::conferir(const Circuit& C, unsigned long long NumVetores, uint64_t Semente) const
+{
+  RASTRO_ESCOPO("conferir LUTs");
+  Netlist N;
+  if (saidas.empty() || !N.compilar(C) || N.getNumInputs()!=Nin || N.getNumOutputs()!=saidas.size())
+  {
+    std::cerr << "Circuito invalido para conferir a rede de LUTs\n";
+    return false;
+  }
+  // Exaustiva se os 3^Nin vetores couberem em NumVetores
+  unsigned long long total = 1;
+  for (unsigned i=0; i<Nin && total<=NumVetores; i++) total *= 3;
+  const bool exaustiva = (total<=NumVetores);
+  if (exaustiva) NumVetores = total;
+
+  std::vector<bool3S_64> S(N.getNumSinais());
+  std::vector<bool3S> in(Nin), out, R(getNumSinais());
+  uint64_t estado = Semente;
+  for (unsigned long long W=0; W*64<NumVetores; W++)
+  {
+    const unsigned pistas = unsigned(std::min<unsigned long long>(64, NumVetores-W*64));
+    // Vetores 64*W a 64*W+pistas-1: na exaustiva, a entrada i eh o digito i do indice,
+    // na base 3; na aleatoria, cerca de 1/4 das entradas fica UNDEF
+    std::fill(S.begin(), S.end(), bool3S_64{0,0});
+    for (unsigned i=0; i<Nin; i++)
+    {
+      if (exaustiva)
+      {
+        for (unsigned l=0; l<pistas; l++)
+        {
+          unsigned long long k = W*64+l;
+          for (unsigned j=0; j<i; j++) k /= 3;
+          fixarPista(S[i], l, bool3S(k%3));
+        }
+      }
+      else
+      {
+        uint64_t t = proximoAleat(estado);
+        uint64_t indef = proximoAleat(estado) & proximoAleat(estado);
+        S[i] = bool3S_64{t & ~indef, ~t & ~indef};
+      }
+    }
+    N.simular(S.data());
+    for (unsigned l=0; l<pistas; l++)
+    {
+      for (unsigned i=0; i<Nin; i++) in[i] = lerPista(S[i], l);
+      simular(in, out);
+      for (unsigned j=0; j<saidas.size(); j++)
+      {
+        if (out[j]==lerPista(S[N.getSaida(j)], l)) continue;
+        std::cerr << "Rede de LUTs diferente do circuito na saida " << j+1 << " para as entradas";
+        for (unsigned i=0; i<Nin; i++) std::cerr << ' ' << in[i];
+        std::cerr << '\n';
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Imprime o numero de portas e de nos, a distribuicao do numero de folhas e a memoria
+std::ostream& operator<<(std::ostream& O, const RedeLUT& R)
+{
+  O << R.getNumPortas() << " porta(s) -> " << R.getNumNos() << " no(s): "
+    << R.getNumLUTs() << " LUT(s) e " << R.getNumNos()-R.getNumLUTs() << " porta(s)";
+  if (R.getNumNos()>0) O << " (" << double(R.getNumPortas())/R.getNumNos() << " portas por no)";
+  O << '\n';
+  std::vector<unsigned> folhas(MAX_K_LUT+1, 0);
+  for (unsigned k=0; k<R.getNumNos(); k++)
+  {
+    if (R.getNumFolhas(k)<=MAX_K_LUT) folhas[R.getNumFolhas(k)]++;
+  }
+  O << "Folhas por no:";
+  for (unsigned m=1; m<=MAX_K_LUT; m++) O << ' ' << m << ": " << folhas[m] << (m<MAX_K_LUT ? ',' : '\n');
+  O << "Tabelas: " << R.getBytesTabelas() << " bytes\n";
+  return O;
+}
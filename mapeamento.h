@@ -0,0 +1,111 @@
+#ifndef _MAPEAMENTO_H_
+#define _MAPEAMENTO_H_
+
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// MAPEAMENTO EM LUTs (tabelas de consulta de ateh K entradas)
+///
+
+// Agrupa as portas do circuito em cones, cada um substituido por um unico no (LUT) cuja
+// tabela verdade de 3 estados eh calculada uma vez. A simulacao avalia um no por cone,
+// com uma leitura de tabela, em vez de uma avaliacao por porta.
+//
+// Mapeamento (na ordem de avaliacao da netlist compilada):
+// - cortes: para cada porta sao enumerados os conjuntos de ateh K sinais (folhas) que
+//   separam a porta das entradas do circuito, combinando os cortes das suas entradas;
+//   apenas os MAX_CORTES_LUT melhores de cada porta sao mantidos (cortes prioritarios);
+// - custo: "fluxo de area" = 1 + soma, nas folhas, do custo da folha dividido pelo seu
+//   fanout, o que favorece cones que nao duplicam logica compartilhada;
+// - cobertura: a partir das saidas do circuito, cada sinal necessario vira um no com o
+//   seu melhor corte, e as folhas desse corte passam a ser necessarias.
+// A tabela de um no tem 3^m entradas (m folhas) de 2 bits (o valor bool3S), na ordem
+// do indice folha[0]*1 + folha[1]*3 + folha[2]*9 + ... (valores UNDEF=0, FALSE=1, TRUE=2).
+// Ela eh calculada simulando o cone (com bool3S_64) para todas as combinacoes das
+// folhas; como o cone nao tem lacos, o resultado eh o mesmo da simulacao porta a porta.
+//
+// As portas que participam de lacos (ou dependem deles) viram nos de uma porta soh, e
+// sao reavaliadas ateh que nenhuma mude, partindo de UNDEF, como em Netlist::simular.
+// Uma porta com mais de K entradas distintas fica como porta (sem tabela). Circuitos
+// com flip-flops nao sao mapeados.
+
+// Numero maximo de entradas de uma LUT
+const unsigned MAX_K_LUT = 6;
+// Numero de cortes mantidos por porta
+const unsigned MAX_CORTES_LUT = 8;
+
+class RedeLUT {
+private:
+  unsigned Nin;
+  // Numero de portas do circuito mapeado
+  unsigned numPortas;
+  // Folhas do no K: folhas[inicioFolhas[K]] ateh folhas[inicioFolhas[K+1]-1]
+  // (indices de sinal da rede: de 0 a Nin-1 as entradas; Nin+K o no K)
+  std::vector<unsigned> inicioFolhas;
+  std::vector<unsigned> folhas;
+  // Inicio da tabela do no K em tabela, ou ~0u se o no eh uma porta (tipo[K])
+  std::vector<unsigned> inicioTabela;
+  std::vector<uint64_t> tabela;
+  std::vector<TipoPorta> tipo;
+  // Sinal de origem de cada saida do circuito
+  std::vector<unsigned> saidas;
+  // Os nos a partir de inicioLaco dependem de lacos
+  unsigned inicioLaco;
+
+  // Calcula a saida do no K a partir dos valores atuais dos sinais
+  inline bool3S avaliar(unsigned K, const bool3S* Sinais) const;
+
+public:
+  RedeLUT();
+
+  // Mapeia o circuito C em LUTs de ateh K entradas (1 <= K <= MAX_K_LUT)
+  // Retorna false (e deixa a rede vazia) se o circuito nao for valido, tiver
+  // flip-flops ou se K for invalido
+  bool mapear(const Circuit& C, unsigned K=MAX_K_LUT);
+
+  // Esvazia a rede
+  void clear();
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumOutputs() const {return saidas.size();}
+  unsigned getNumNos() const {return inicioTabela.size();}
+  unsigned getNumSinais() const {return Nin+inicioTabela.size();}
+  // Numero de portas do circuito original
+  unsigned getNumPortas() const {return numPortas;}
+  // Numero de nos que sao LUTs (os demais sao portas)
+  unsigned getNumLUTs() const;
+  // Numero de folhas do no K
+  unsigned getNumFolhas(unsigned K) const {return inicioFolhas[K+1]-inicioFolhas[K];}
+  // Memoria ocupada pelas tabelas, em bytes
+  size_t getBytesTabelas() const {return tabela.size()*sizeof(uint64_t);}
+
+  // Simula a rede para um vetor de entradas
+  // Sinais deve ter getNumSinais() elementos, com as entradas (0 a Nin-1) jah fixadas;
+  // ao final, contem os valores de todos os nos
+  void simular(bool3S* Sinais) const;
+
+  // Simula a rede para um vetor de entradas e retorna as saidas do circuito
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const;
+
+  // Simula pela rede os estimulos da stream I (ver estimulo.h) e escreve em O uma linha
+  // "entradas TAB saidas" por vetor (como simularFluxo)
+  // Retorna false (com uma mensagem em cerr) se a rede estiver vazia ou se algum estimulo
+  // for invalido; nesse caso, os vetores anteriores ao erro jah foram escritos.
+  bool simularEstimulos(std::istream& I, std::ostream& O) const;
+
+  // Confere a rede com a simulacao da netlist do circuito original C (que deve ser o
+  // circuito mapeado): todos os vetores, se forem ateh NumVetores, ou NumVetores vetores
+  // aleatorios (com algumas entradas ?) gerados a partir da Semente
+  // Retorna false (com o primeiro vetor diferente em cerr) se alguma saida diferir
+  bool conferir(const Circuit& C, unsigned long long NumVetores=4096, uint64_t Semente=1) const;
+};
+
+// Imprime o numero de portas e de nos, a distribuicao do numero de folhas e a memoria
+std::ostream& operator<<(std::ostream& O, const RedeLUT& R);
+
+#endif // _MAPEAMENTO_H_
@@ -0,0 +1,278 @@
+#include "netlist.h"
+#include "rastro.h"
+
+// Converte uma sigla (NT, AN, ...) para o tipo correspondente
+// Retorna false se a sigla nao for valida
+bool tipoPorta(const std::string& Sigla, TipoPorta& T)
+{
+  if (Sigla=="NT") T = TipoPorta::NT;
+  else if (Sigla=="AN") T = TipoPorta::AN;
+  else if (Sigla=="NA") T = TipoPorta::NA;
+  else if (Sigla=="OR") T = TipoPorta::OR;
+  else if (Sigla=="NO") T = TipoPorta::NO;
+  else if (Sigla=="XO") T = TipoPorta::XO;
+  else if (Sigla=="NX") T = TipoPorta::NX;
+  else if (Sigla=="FF") T = TipoPorta::FF;
+  else return false;
+  return true;
+}
+
+// Retorna a sigla (NT, AN, ...) de um tipo de porta
+std::string siglaPorta(TipoPorta T)
+{
+  switch (T)
+  {
+  case TipoPorta::NT: return "NT";
+  case TipoPorta::AN: return "AN";
+  case TipoPorta::NA: return "NA";
+  case TipoPorta::OR: return "OR";
+  case TipoPorta::NO: return "NO";
+  case TipoPorta::XO: return "XO";
+  case TipoPorta::NX: return "NX";
+  case TipoPorta::FF: return "FF";
+  }
+  return "??";
+}
+
+// Calcula a saida de uma porta do tipo T com as N entradas In (versao escalar)
+bool3S avaliarPorta(TipoPorta T, const bool3S* In, unsigned N)
+{
+  bool3S prov = In[0];
+  switch (T)
+  {
+  case TipoPorta::NT:
+    return ~prov;
+  case TipoPorta::FF:
+    return bool3S::UNDEF;
+  case TipoPorta::AN:
+  case TipoPorta::NA:
+    for (unsigned i=1; i<N; i++) prov &= In[i];
+    return (T==TipoPorta::AN) ? prov : ~prov;
+  case TipoPorta::OR:
+  case TipoPorta::NO:
+    for (unsigned i=1; i<N; i++) prov |= In[i];
+    return (T==TipoPorta::OR) ? prov : ~prov;
+  case TipoPorta::XO:
+  case TipoPorta::NX:
+  default:
+    for (unsigned i=1; i<N; i++) prov ^= In[i];
+    return (T==TipoPorta::XO) ? prov : ~prov;
+  }
+}
+
+///
+/// CLASSE NETLIST
+///
+
+/// ***********************
+/// Inicializacao
+/// ***********************
+
+Netlist::Netlist(): Nin(0), inicioLaco(0), Nniveis(0) {}
+
+// Compila o circuito C (ver compilar)
+Netlist::Netlist(const Circuit& C): Netlist()
+{
+  compilar(C);
+}
+
+// Esvazia a netlist
+void Netlist::clear()
+{
+  Nin = 0;
+  tipo.clear();
+  inicioEntr.clear();
+  entr.clear();
+  saidas.clear();
+  ordem.clear();
+  inicioLaco = 0;
+  nivel.clear();
+  Nniveis = 0;
+  inicioFanout.clear();
+  fanout.clear();
+  flipflops.clear();
+}
+
+// Compila o circuito C: copia a estrutura, calcula a ordem de avaliacao, os niveis e o fanout
+// Retorna false (e deixa a netlist vazia) se o circuito nao for valido
+bool Netlist::compilar(const Circuit& C)
+{
+  RASTRO_ESCOPO("levelizar");
+  clear();
+  if (!C.valid()) return false;
+
+  // Estrutura
+  Nin = C.getNumInputs();
+  const unsigned NP = C.getNumPorts();
+  tipo.resize(NP);
+  inicioEntr.resize(NP+1);
+  for (unsigned p=0; p<NP; p++)
+  {
+    tipoPorta(C.getNamePort(p+1), tipo[p]);
+    inicioEntr[p] = entr.size();
+    for (unsigned j=0; j<C.getNumInputsPort(p+1); j++) entr.push_back(sinal(C.getId_inPort(p+1,j)));
+  }
+  inicioEntr[NP] = entr.size();
+  for (unsigned j=0; j<C.getNumOutputs(); j++) saidas.push_back(sinal(C.getIdOutput(j+1)));
+  for (unsigned p=0; p<NP; p++) if (tipo[p]==TipoPorta::FF) flipflops.push_back(p);
+
+  // Fanout (contagem, depois preenchimento), sem as entradas D dos flip-flops
+  const unsigned NS = getNumSinais();
+  inicioFanout.assign(NS+1, 0);
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (tipo[p]==TipoPorta::FF) continue;
+    for (unsigned k=inicioEntr[p]; k<inicioEntr[p+1]; k++) inicioFanout[entr[k]+1]++;
+  }
+  for (unsigned s=0; s<NS; s++) inicioFanout[s+1] += inicioFanout[s];
+  fanout.resize(inicioFanout[NS]);
+  std::vector<unsigned> pos(inicioFanout.begin(), inicioFanout.end()-1);
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (tipo[p]==TipoPorta::FF) continue;
+    for (unsigned k=inicioEntr[p]; k<inicioEntr[p+1]; k++) fanout[pos[entr[k]]++] = p;
+  }
+
+  // Levelizacao (algoritmo de Kahn): uma porta fica pronta quando todas as portas
+  // que a alimentam jah foram processadas (os flip-flops ficam prontos desde o inicio)
+  std::vector<unsigned> falta(NP, 0);
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (tipo[p]==TipoPorta::FF) continue;
+    for (unsigned k=inicioEntr[p]; k<inicioEntr[p+1]; k++) if (entr[k]>=Nin) falta[p]++;
+  }
+  nivel.assign(NP, 0);
+  std::vector<unsigned> prontas;
+  prontas.reserve(NP);
+  for (unsigned p=0; p<NP; p++) if (falta[p]==0) {prontas.push_back(p); nivel[p] = 1;}
+  for (unsigned i=0; i<prontas.size(); i++)
+  {
+    unsigned p = prontas[i];
+    unsigned s = Nin+p;
+    for (unsigned k=inicioFanout[s]; k<inicioFanout[s+1]; k++)
+    {
+      unsigned q = fanout[k];
+      if (nivel[p]+1 > nivel[q]) nivel[q] = nivel[p]+1;
+      if (--falta[q]==0) prontas.push_back(q);
+    }
+  }
+  Nniveis = 0;
+  for (unsigned p : prontas) if (nivel[p]>Nniveis) Nniveis = nivel[p];
+
+  // Ordem: portas sem lacos por nivel (e por id dentro do nivel); depois as demais por id
+  std::vector<unsigned> inicioNivel(Nniveis+2, 0);
+  for (unsigned p : prontas) inicioNivel[nivel[p]+1]++;
+  for (unsigned n=1; n<=Nniveis; n++) inicioNivel[n+1] += inicioNivel[n];
+  ordem.resize(NP);
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (falta[p]==0) ordem[inicioNivel[nivel[p]]++] = p;
+  }
+  inicioLaco = prontas.size();
+  if (inicioLaco<NP) Nniveis++;
+  unsigned k = inicioLaco;
+  for (unsigned p=0; p<NP; p++)
+  {
+    if (falta[p]!=0)
+    {
+      ordem[k++] = p;
+      nivel[p] = Nniveis;
+    }
+  }
+  return true;
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+// Simula o circuito para 64 vetores de entrada ao mesmo tempo
+void Netlist::simular(bool3S_64* Sinais, const bool3S_64* Forca) const
+{
+  const unsigned NP = getNumPorts();
+  if (Forca!=nullptr)
+  {
+    for (unsigned s=0; s<Nin; s++) Sinais[s] = forcar(Sinais[s], Forca[s]);
+  }
+
+  // Parte sem lacos: uma unica passada
+  for (unsigned i=0; i<inicioLaco; i++)
+  {
+    unsigned p = ordem[i];
+    bool3S_64 v = avaliar(p, Sinais);
+    if (Forca!=nullptr) v = forcar(v, Forca[Nin+p]);
+    Sinais[Nin+p] = v;
+  }
+  if (inicioLaco==NP) return;
+
+  // Parte com lacos: parte de UNDEF e reavalia ateh o ponto fixo
+  for (unsigned i=inicioLaco; i<NP; i++)
+  {
+    unsigned p = ordem[i];
+    Sinais[Nin+p] = (Forca!=nullptr) ? forcar(bool3S_64{0,0}, Forca[Nin+p]) : bool3S_64{0,0};
+  }
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned i=inicioLaco; i<NP; i++)
+    {
+      unsigned p = ordem[i];
+      bool3S_64 v = avaliar(p, Sinais);
+      if (Forca!=nullptr) v = forcar(v, Forca[Nin+p]);
+      if (v!=Sinais[Nin+p])
+      {
+        Sinais[Nin+p] = v;
+        mudou = true;
+      }
+    }
+  } while (mudou);
+}
+
+// Simula o circuito com 2 valores (sem lacos e sem flip-flops)
+void Netlist::simularBinario(uint64_t* Sinais) const
+{
+  for (unsigned i=0; i<inicioLaco; i++)
+  {
+    unsigned p = ordem[i];
+    const unsigned* e = entr.data()+inicioEntr[p];
+    const unsigned* fim = entr.data()+inicioEntr[p+1];
+    uint64_t v = Sinais[*e];
+    switch (tipo[p])
+    {
+    case TipoPorta::NT:
+      v = ~v;
+      break;
+    case TipoPorta::AN:
+    case TipoPorta::NA:
+      for (e++; e<fim; e++) v &= Sinais[*e];
+      if (tipo[p]==TipoPorta::NA) v = ~v;
+      break;
+    case TipoPorta::OR:
+    case TipoPorta::NO:
+      for (e++; e<fim; e++) v |= Sinais[*e];
+      if (tipo[p]==TipoPorta::NO) v = ~v;
+      break;
+    case TipoPorta::XO:
+    case TipoPorta::NX:
+    default:
+      for (e++; e<fim; e++) v ^= Sinais[*e];
+      if (tipo[p]==TipoPorta::NX) v = ~v;
+      break;
+    }
+    Sinais[Nin+p] = v;
+  }
+}
+
+// Simula o circuito para um unico vetor de entradas
+// Retorna false se a dimensao da entrada for invalida
+bool Netlist::simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const
+{
+  if (in_circ.size()!=Nin || tipo.empty()) return false;
+  std::vector<bool3S_64> S(getNumSinais(), bool3S_64{0,0});
+  for (unsigned i=0; i<Nin; i++) S[i] = difundir(in_circ[i]);
+  simular(S.data());
+  out_circ.resize(saidas.size());
+  for (unsigned j=0; j<saidas.size(); j++) out_circ[j] = lerPista(S[saidas[j]], 0);
+  return true;
+}
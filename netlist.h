@@ -0,0 +1,195 @@
+#ifndef _NETLIST_H_
+#define _NETLIST_H_
+
+#include <string>
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+
+///
+/// NETLIST COMPILADA (levelizada) DE UM CIRCUITO
+///
+
+// Representacao compacta e somente de leitura de um Circuit valido, usada pelos
+// motores de simulacao rapidos (simulacao bit-paralela, simulacao de falhas etc.).
+// Em vez de ponteiros para Port e ids com sinal, usa vetores contiguos e indices:
+//
+// - sinal S: de 0 a Nin-1 sao as entradas do circuito (id -1 -> sinal 0, id -2 -> sinal 1, ...)
+//            de Nin a Nin+Nports-1 sao as saidas das portas (id 1 -> sinal Nin, ...)
+// - porta P: de 0 a Nports-1 (id IdPort -> porta IdPort-1); a saida da porta P eh o sinal Nin+P
+//
+// As portas sao ordenadas por nivel (levelizacao): cada porta fora de lacos vem depois de
+// todas as portas que a alimentam. As portas que participam de lacos de realimentacao ou
+// que dependem deles ficam no final da ordem, na ordem das ids.
+//
+// A simulacao de uma netlist sem lacos eh uma unica passada na ordem de avaliacao.
+// Com lacos, as portas do final da ordem sao reavaliadas ateh que nenhuma mude, partindo
+// de UNDEF. Como a logica de 3 estados eh monotona, o resultado eh exatamente o mesmo
+// ponto fixo calculado por Circuit::simular.
+//
+// Um flip-flop (FF) eh uma fonte de sinal, como uma entrada do circuito: o valor do seu
+// sinal eh o estado armazenado, que deve ser fixado em Sinais antes de simular (como as
+// entradas). A sua entrada D nao conta na levelizacao e nao entra no fanout, de modo que
+// os flip-flops quebram os lacos dos circuitos sequenciais.
+
+// Os tipos de porta, em uma forma adequada para "switch"
+enum class TipoPorta : unsigned char {NT, AN, NA, OR, NO, XO, NX, FF};
+
+// Converte uma sigla (NT, AN, ...) para o tipo correspondente
+// Retorna false se a sigla nao for valida
+bool tipoPorta(const std::string& Sigla, TipoPorta& T);
+
+// Retorna a sigla (NT, AN, ...) de um tipo de porta
+std::string siglaPorta(TipoPorta T);
+
+// Calcula a saida de uma porta do tipo T com as N entradas In (versao escalar)
+// Para um flip-flop, cujo estado nao eh conhecido aqui, retorna UNDEF
+bool3S avaliarPorta(TipoPorta T, const bool3S* In, unsigned N);
+
+// Calcula a saida de uma porta do tipo T cujas N entradas sao os sinais
+// Sinais[e[0]] ... Sinais[e[N-1]], com valores V = bool3S ou bool3S_64 (64 pistas)
+// Os flip-flops devem ser tratados por quem chama (o seu valor eh o estado armazenado)
+template <class V>
+inline V avaliarPorta(TipoPorta T, const unsigned* e, unsigned N, const V* Sinais)
+{
+  V prov = Sinais[e[0]];
+  switch (T)
+  {
+  case TipoPorta::NT:
+    return ~prov;
+  case TipoPorta::AN:
+  case TipoPorta::NA:
+    for (unsigned i=1; i<N; i++) prov &= Sinais[e[i]];
+    return (T==TipoPorta::AN) ? prov : ~prov;
+  case TipoPorta::OR:
+  case TipoPorta::NO:
+    for (unsigned i=1; i<N; i++) prov |= Sinais[e[i]];
+    return (T==TipoPorta::OR) ? prov : ~prov;
+  case TipoPorta::XO:
+  case TipoPorta::NX:
+  default:
+    for (unsigned i=1; i<N; i++) prov ^= Sinais[e[i]];
+    return (T==TipoPorta::XO) ? prov : ~prov;
+  }
+}
+
+// Forca valores em pistas de um bool3S_64 (usado para injetar falhas):
+// as pistas com bit 1 em F.t passam a valer TRUE; as com bit 1 em F.f passam a valer FALSE
+inline bool3S_64 forcar(const bool3S_64& X, const bool3S_64& F)
+{
+  return {(X.t & ~F.f) | F.t, (X.f & ~F.t) | F.f};
+}
+
+class Netlist {
+private:
+  unsigned Nin;
+  // Tipo de cada porta
+  std::vector<TipoPorta> tipo;
+  // Entradas da porta P: entr[inicioEntr[P]] ateh entr[inicioEntr[P+1]-1] (indices de sinal)
+  std::vector<unsigned> inicioEntr;
+  std::vector<unsigned> entr;
+  // Sinal de origem de cada saida do circuito
+  std::vector<unsigned> saidas;
+  // Ordem de avaliacao das portas; as portas a partir de ordem[inicioLaco] dependem de lacos
+  std::vector<unsigned> ordem;
+  unsigned inicioLaco;
+  // Nivel de cada porta (1 para portas alimentadas apenas por entradas do circuito)
+  // As portas em lacos recebem o nivel Nniveis
+  std::vector<unsigned> nivel;
+  unsigned Nniveis;
+  // Portas alimentadas pelo sinal S: fanout[inicioFanout[S]] ateh fanout[inicioFanout[S+1]-1]
+  std::vector<unsigned> inicioFanout;
+  std::vector<unsigned> fanout;
+  // Portas que sao flip-flops, em ordem crescente
+  std::vector<unsigned> flipflops;
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  Netlist();
+  // Compila o circuito C (ver compilar)
+  explicit Netlist(const Circuit& C);
+
+  // Compila o circuito C: copia a estrutura, calcula a ordem de avaliacao, os niveis e o fanout
+  // Retorna false (e deixa a netlist vazia) se o circuito nao for valido
+  bool compilar(const Circuit& C);
+
+  // Esvazia a netlist
+  void clear();
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumInputs() const {return Nin;}
+  unsigned getNumOutputs() const {return saidas.size();}
+  unsigned getNumPorts() const {return tipo.size();}
+  unsigned getNumSinais() const {return Nin+tipo.size();}
+
+  // Conversao entre ids (convencao de Circuit) e indices de sinal
+  unsigned sinal(int IdOrig) const {return IdOrig<0 ? unsigned(-IdOrig-1) : Nin+unsigned(IdOrig)-1;}
+  int idSinal(unsigned S) const {return S<Nin ? -int(S)-1 : int(S-Nin)+1;}
+
+  TipoPorta getTipo(unsigned P) const {return tipo[P];}
+  unsigned getNumInputsPort(unsigned P) const {return inicioEntr[P+1]-inicioEntr[P];}
+  const unsigned* getEntradas(unsigned P) const {return entr.data()+inicioEntr[P];}
+
+  // Sinal de origem da saida J do circuito (de 0 a Nout-1)
+  unsigned getSaida(unsigned J) const {return saidas[J];}
+
+  // Ordem de avaliacao das portas e inicio da parte com lacos
+  const std::vector<unsigned>& getOrdem() const {return ordem;}
+  unsigned getInicioLaco() const {return inicioLaco;}
+  // Retorna true se ha lacos de realimentacao
+  bool realimentada() const {return inicioLaco<ordem.size();}
+  // Retorna true se a netlist pode ser simulada com 2 valores (simularBinario): sem lacos
+  // e sem flip-flops, nenhum sinal pode valer ? quando todas as entradas sao F ou T
+  bool binaria() const {return !tipo.empty() && !realimentada() && flipflops.empty();}
+
+  unsigned getNivel(unsigned P) const {return nivel[P];}
+  unsigned getNumNiveis() const {return Nniveis;}
+
+  // Portas alimentadas pelo sinal S
+  unsigned getNumFanout(unsigned S) const {return inicioFanout[S+1]-inicioFanout[S];}
+  const unsigned* getFanout(unsigned S) const {return fanout.data()+inicioFanout[S];}
+
+  // Portas que sao flip-flops (a entrada D da porta P eh getEntradas(P)[0])
+  const std::vector<unsigned>& getFlipFlops() const {return flipflops;}
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Calcula a saida da porta P a partir dos valores atuais dos sinais
+  inline bool3S_64 avaliar(unsigned P, const bool3S_64* Sinais) const;
+
+  // Simula o circuito para 64 vetores de entrada ao mesmo tempo
+  // Sinais deve ter getNumSinais() elementos, com as entradas (0 a Nin-1) e os estados
+  // dos flip-flops jah fixados
+  // Ao final, contem as saidas de todas as portas
+  // Se Forca != nullptr (tambem com getNumSinais() elementos), os valores forcados em
+  // Forca[S] sao aplicados ao sinal S (entrada ou porta) a cada avaliacao (ver forcar)
+  void simular(bool3S_64* Sinais, const bool3S_64* Forca=nullptr) const;
+
+  // Simula o circuito com 2 valores para 64 vetores de entrada ao mesmo tempo, um bit
+  // por pista (1: T; 0: F), com as operacoes bit a bit comuns
+  // Soh pode ser usada se binaria(); o resultado eh o mesmo de simular com entradas F/T
+  // Sinais deve ter getNumSinais() elementos, com as entradas (0 a Nin-1) jah fixadas
+  void simularBinario(uint64_t* Sinais) const;
+
+  // Simula o circuito para um unico vetor de entradas (com os flip-flops em UNDEF)
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ) const;
+};
+
+// Calcula a saida da porta P a partir dos valores atuais dos sinais
+inline bool3S_64 Netlist::avaliar(unsigned P, const bool3S_64* Sinais) const
+{
+  if (tipo[P]==TipoPorta::FF) return Sinais[Nin+P];
+  return avaliarPorta(tipo[P], entr.data()+inicioEntr[P], inicioEntr[P+1]-inicioEntr[P], Sinais);
+}
+
+#endif // _NETLIST_H_
@@ -0,0 +1,119 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "rastro.h"
+
+///
+/// Buffer circular de uma thread
+///
+
+struct EventoRastro {
+  const char* nome;
+  uint64_t ns;     // nanossegundos desde o inicio do programa
+  char fase;       // 'B' (inicio) ou 'E' (fim)
+};
+
+struct BufferRastro {
+  EventoRastro eventos[CAPACIDADE_RASTRO];
+  // Numero total de eventos jah gravados (apenas a thread dona escreve)
+  std::atomic<uint64_t> gravados;
+  unsigned tid;
+  // Proximo buffer na lista de todas as threads
+  BufferRastro* prox;
+};
+
+// Lista (sem travas) dos buffers de todas as threads que jah registraram eventos
+// Os buffers nunca sao liberados, para que possam ser salvos mesmo depois que
+// as threads terminarem
+static std::atomic<BufferRastro*> listaBuffers(nullptr);
+static std::atomic<unsigned> proximaTid(1);
+
+// Instante de referencia do rastro
+static const std::chrono::steady_clock::time_point inicioRastro = std::chrono::steady_clock::now();
+
+// Salva o rastro no final do programa
+static void salvarRastroNaSaida()
+{
+  const char* arq = std::getenv("CIRCUITO_RASTRO");
+  salvarRastro(arq!=nullptr ? arq : "rastro.json");
+}
+
+// Retorna o buffer da thread atual, criando-o no primeiro uso
+static BufferRastro* bufferThread()
+{
+  thread_local BufferRastro* B = nullptr;
+  if (B==nullptr)
+  {
+    B = new BufferRastro;
+    B->gravados.store(0, std::memory_order_relaxed);
+    B->tid = proximaTid.fetch_add(1);
+    // O primeiro buffer criado agenda o salvamento no final do programa
+    if (B->tid==1) std::atexit(salvarRastroNaSaida);
+    B->prox = listaBuffers.load(std::memory_order_relaxed);
+    while (!listaBuffers.compare_exchange_weak(B->prox, B, std::memory_order_release,
+                                               std::memory_order_relaxed));
+  }
+  return B;
+}
+
+// Registra um evento de inicio (Fase=='B') ou de fim (Fase=='E') na thread atual
+void registrarRastro(const char* Nome, char Fase)
+{
+  BufferRastro* B = bufferThread();
+  uint64_t n = B->gravados.load(std::memory_order_relaxed);
+  EventoRastro& E = B->eventos[n & (CAPACIDADE_RASTRO-1)];
+  E.nome = Nome;
+  E.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now()-inicioRastro).count();
+  E.fase = Fase;
+  B->gravados.store(n+1, std::memory_order_release);
+}
+
+// Imprime uma string JSON (com as aspas e os escapes necessarios)
+static void imprimirJSON(std::ostream& O, const char* S)
+{
+  O << '"';
+  for (; *S; S++)
+  {
+    if (*S=='"' || *S=='\\') O << '\\';
+    O << *S;
+  }
+  O << '"';
+}
+
+// Salva os eventos de todas as threads no formato JSON do Chrome trace
+bool salvarRastro(const std::string& arq)
+{
+  BufferRastro* lista = listaBuffers.load(std::memory_order_acquire);
+  if (lista==nullptr) return true;
+
+  std::ofstream arquivo(arq);
+  if (!arquivo.is_open())
+  {
+    std::cerr << "erro ao salvar rastro em " << arq << "\n\n";
+    return false;
+  }
+  arquivo << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool primeiro = true;
+  for (BufferRastro* B=lista; B!=nullptr; B=B->prox)
+  {
+    uint64_t fim = B->gravados.load(std::memory_order_acquire);
+    uint64_t ini = (fim > CAPACIDADE_RASTRO) ? fim-CAPACIDADE_RASTRO : 0;
+    for (uint64_t n=ini; n<fim; n++)
+    {
+      const EventoRastro& E = B->eventos[n & (CAPACIDADE_RASTRO-1)];
+      arquivo << (primeiro ? "\n" : ",\n") << "{\"name\":";
+      imprimirJSON(arquivo, E.nome);
+      arquivo << ",\"ph\":\"" << E.fase << "\",\"ts\":" << E.ns/1000 << '.'
+              << (E.ns%1000)/100 << (E.ns%100)/10 << E.ns%10
+              << ",\"pid\":1,\"tid\":" << B->tid << '}';
+      primeiro = false;
+    }
+  }
+  arquivo << "\n]}\n";
+  return bool(arquivo);
+}
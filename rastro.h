@@ -0,0 +1,51 @@
+#ifndef _RASTRO_H_
+#define _RASTRO_H_
+
+#include <string>
+
+///
+/// RASTRO DE EXECUCAO (formato Chrome trace / Perfetto)
+///
+
+// Registra eventos de inicio e fim (com a id da thread) das fases de leitura,
+// validacao, levelizacao, simulacao e escrita, para que se possa ver em uma linha
+// do tempo (chrome://tracing ou ui.perfetto.dev) onde o programa esta gastando tempo.
+//
+// O rastro soh existe se o programa for compilado com a macro CIRCUITO_RASTRO
+// definida (-DCIRCUITO_RASTRO). Sem ela, RASTRO_ESCOPO nao gera nenhum codigo.
+//
+// Cada thread grava os seus eventos em um buffer circular proprio (sem travas):
+// quando o buffer enche, os eventos mais antigos sao sobrescritos, de modo que
+// sempre estao disponiveis os ultimos CAPACIDADE_RASTRO eventos de cada thread.
+// Ao final do programa, os eventos sao salvos em JSON no arquivo indicado pela
+// variavel de ambiente CIRCUITO_RASTRO (ou "rastro.json", se ela nao existir).
+
+// Numero de eventos guardados por thread (potencia de 2)
+const unsigned CAPACIDADE_RASTRO = 1u << 16;
+
+// Registra um evento de inicio (Fase=='B') ou de fim (Fase=='E') na thread atual
+// Nome deve ser uma string literal (apenas o ponteiro eh guardado)
+void registrarRastro(const char* Nome, char Fase);
+
+// Salva os eventos de todas as threads no formato JSON do Chrome trace
+// Retorna true se deu tudo OK; false se deu erro
+bool salvarRastro(const std::string& arq);
+
+// Objeto que registra o inicio de um escopo ao ser criado e o fim ao ser destruido
+class EscopoRastro {
+private:
+  const char* nome;
+public:
+  EscopoRastro(const char* Nome): nome(Nome) {registrarRastro(nome,'B');}
+  ~EscopoRastro() {registrarRastro(nome,'E');}
+};
+
+#ifdef CIRCUITO_RASTRO
+#define RASTRO_CONCAT2(a,b) a##b
+#define RASTRO_CONCAT(a,b) RASTRO_CONCAT2(a,b)
+#define RASTRO_ESCOPO(Nome) EscopoRastro RASTRO_CONCAT(escopo_rastro_,__LINE__)(Nome)
+#else
+#define RASTRO_ESCOPO(Nome) do {} while (false)
+#endif
+
+#endif // _RASTRO_H_
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "reordenacao.h"
+#include "netlist.h"
+#include "rastro.h"
+
+// Calcula a nova ordem das portas de C
+bool calcularOrdemPortas(const Circuit& C, std::vector<int>& NovaId)
+{
+  RASTRO_ESCOPO("calcular ordem das portas");
+  Netlist N;
+  if (!N.compilar(C)) return false;
+  const unsigned Nin = N.getNumInputs();
+  const unsigned NP = N.getNumPorts();
+  const unsigned Nniveis = N.getNumNiveis();
+
+  // Portas de cada nivel (1 a Nniveis), inicialmente por id
+  std::vector<std::vector<unsigned>> niveis(Nniveis+1);
+  for (unsigned P=0; P<NP; P++) niveis[N.getNivel(P)].push_back(P);
+  // Posicao de cada sinal na ordem: as entradas antes de todas as portas
+  std::vector<double> pos(N.getNumSinais());
+  for (unsigned i=0; i<Nin; i++) pos[i] = double(i)-double(Nin);
+  {
+    unsigned k = 0;
+    for (unsigned L=1; L<=Nniveis; L++) for (unsigned P : niveis[L]) pos[Nin+P] = k++;
+  }
+  std::vector<double> chave(NP);
+
+  // Ordena o nivel L pela chave e atualiza as posicoes das suas portas
+  auto ordenar = [&](unsigned L)
+  {
+    std::vector<unsigned>& V = niveis[L];
+    if (V.empty()) return;
+    double inicio = pos[Nin+V[0]];
+    for (unsigned P : V) inicio = std::min(inicio, pos[Nin+P]);
+    std::stable_sort(V.begin(), V.end(), [&](unsigned P, unsigned Q) {return chave[P]<chave[Q];});
+    for (unsigned k=0; k<V.size(); k++) pos[Nin+V[k]] = inicio+k;
+  };
+  // Baricentro das entradas da porta P
+  auto baricentroEntradas = [&](unsigned P)
+  {
+    const unsigned* e = N.getEntradas(P);
+    const unsigned n = N.getNumInputsPort(P);
+    double soma = 0.0;
+    for (unsigned k=0; k<n; k++) soma += pos[e[k]];
+    return soma/n;
+  };
+  // Baricentro das portas alimentadas por P (a propria posicao, se nao houver)
+  auto baricentroFanout = [&](unsigned P)
+  {
+    const unsigned* f = N.getFanout(Nin+P);
+    const unsigned n = N.getNumFanout(Nin+P);
+    if (n==0) return pos[Nin+P];
+    double soma = 0.0;
+    for (unsigned k=0; k<n; k++) soma += pos[Nin+f[k]];
+    return soma/n;
+  };
+
+  // Entradas (do primeiro ao ultimo nivel), fanout (do penultimo ao primeiro) e entradas
+  for (unsigned L=1; L<=Nniveis; L++)
+  {
+    for (unsigned P : niveis[L]) chave[P] = baricentroEntradas(P);
+    ordenar(L);
+  }
+  for (unsigned L=Nniveis; L-- > 1; )
+  {
+    for (unsigned P : niveis[L]) chave[P] = baricentroFanout(P);
+    ordenar(L);
+  }
+  for (unsigned L=1; L<=Nniveis; L++)
+  {
+    for (unsigned P : niveis[L]) chave[P] = baricentroEntradas(P);
+    ordenar(L);
+  }
+
+  NovaId.resize(NP);
+  for (unsigned P=0; P<NP; P++) NovaId[P] = int(pos[Nin+P])+1;
+  return true;
+}
+
+// Renumera as portas de C
+bool renumerarPortas(Circuit& C, const std::vector<int>& NovaId)
+{
+  RASTRO_ESCOPO("renumerar portas");
+  const unsigned NP = C.getNumPorts();
+  if (!C.valid() || NovaId.size()!=NP) return false;
+  std::vector<bool> usada(NP, false);
+  for (int Id : NovaId)
+  {
+    if (Id<1 || Id>int(NP) || usada[Id-1]) return false;
+    usada[Id-1] = true;
+  }
+  // Nova id de uma origem (as entradas do circuito nao mudam)
+  auto novaOrigem = [&](int IdOrig) {return IdOrig>0 ? NovaId[IdOrig-1] : IdOrig;};
+
+  Circuit D;
+  D.resize(C.getNumInputs(), C.getNumOutputs(), NP);
+  for (unsigned P=0; P<NP; P++)
+  {
+    const int id = NovaId[P];
+    const unsigned n = C.getNumInputsPort(P+1);
+    D.setPort(id, C.getNamePort(P+1), n);
+    for (unsigned j=0; j<n; j++) D.setId_inPort(id, j, novaOrigem(C.getId_inPort(P+1, j)));
+  }
+  for (unsigned j=1; j<=C.getNumOutputs(); j++) D.setIdOutput(j, novaOrigem(C.getIdOutput(j)));
+  const bool tabulado = C.tabulado();
+  C = D;
+  if (tabulado) C.tabular();
+  return true;
+}
+
+// Calcula a nova ordem e renumera as portas de C
+bool reordenarPortas(Circuit& C, std::vector<int>* NovaId)
+{
+  std::vector<int> nova;
+  if (!calcularOrdemPortas(C, nova) || !renumerarPortas(C, nova)) return false;
+  if (NovaId!=nullptr) *NovaId = nova;
+  return true;
+}
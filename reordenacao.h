@@ -0,0 +1,40 @@
+#ifndef _REORDENACAO_H_
+#define _REORDENACAO_H_
+
+#include <vector>
+#include "circuit.h"
+
+///
+/// REORDENACAO DAS PORTAS (localidade de memoria)
+///
+
+// As ids das portas seguem a ordem em que o arquivo as listou, de modo que, em circuitos
+// grandes, a simulacao le as saidas de portas espalhadas pela memoria. A reordenacao
+// renumera as portas para que as portas vizinhas na ordem de avaliacao tambem sejam
+// vizinhas na memoria:
+// - as portas sao agrupadas por nivel (ver Netlist), na ordem dos niveis; as portas em
+//   lacos ficam no fim;
+// - dentro de cada nivel, as portas sao ordenadas pelo baricentro (posicao media) das
+//   portas que as alimentam, de modo que portas com entradas em comum ficam juntas;
+//   depois, do ultimo nivel para o primeiro, pelo baricentro das portas que elas
+//   alimentam (fanout); e, por fim, de novo pelas entradas.
+// Como cada porta passa a ter uma id maior que as das portas que a alimentam (fora dos
+// lacos), Circuit::simular tambem precisa de menos varreduras.
+// Todas as referencias (entradas das portas e saidas do circuito) sao renumeradas; o
+// circuito resultante eh equivalente e pode ser salvo normalmente. O estado dos
+// flip-flops nao eh preservado (volta a UNDEF).
+
+// Calcula a nova ordem das portas de C: NovaId[P] eh a nova id da porta de id P+1
+// Retorna false se o circuito nao for valido
+bool calcularOrdemPortas(const Circuit& C, std::vector<int>& NovaId);
+
+// Renumera as portas de C: a porta de id P+1 passa a ter a id NovaId[P]
+// (NovaId deve ser uma permutacao de 1 a C.getNumPorts())
+// Retorna false (sem alterar C) se o circuito nao for valido ou NovaId for invalido
+bool renumerarPortas(Circuit& C, const std::vector<int>& NovaId);
+
+// Calcula a nova ordem e renumera as portas de C
+// Se NovaId != nullptr, recebe a permutacao aplicada (ver calcularOrdemPortas)
+bool reordenarPortas(Circuit& C, std::vector<int>* NovaId=nullptr);
+
+#endif // _REORDENACAO_H_
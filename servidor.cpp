@@ -0,0 +1,571 @@
+#include <iostream>
+#include <cstring>
+#include <system_error>
+#include "servidor.h"
+#include "importar.h"
+#include "rastro.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+// Tamanho maximo dos dados de um pedido (64 MB)
+static const uint32_t MAX_DADOS_PEDIDO = 64u << 20;
+
+///
+/// Funcoes auxiliares de comunicacao
+///
+
+#ifndef _WIN32
+// Leh exatamente N bytes; retorna false se a conexao foi fechada ou deu erro
+static bool lerTudo(int Fd, void* Buf, size_t N)
+{
+  char* p = static_cast<char*>(Buf);
+  while (N>0)
+  {
+    ssize_t k = ::recv(Fd, p, N, 0);
+    if (k<0 && errno==EINTR) continue;
+    if (k<=0) return false;
+    p += k;
+    N -= size_t(k);
+  }
+  return true;
+}
+
+// Escreve exatamente N bytes; retorna false se deu erro
+static bool escreverTudo(int Fd, const void* Buf, size_t N)
+{
+  const char* p = static_cast<const char*>(Buf);
+  while (N>0)
+  {
+    ssize_t k = ::send(Fd, p, N, MSG_NOSIGNAL);
+    if (k<0 && errno==EINTR) continue;
+    if (k<=0) return false;
+    p += k;
+    N -= size_t(k);
+  }
+  return true;
+}
+#endif
+
+// Confere se todos os bytes sao valores logicos validos (0, 1 ou 2)
+static bool valoresValidos(const uint8_t* V, size_t N)
+{
+  for (size_t i=0; i<N; i++) if (V[i]>2) return false;
+  return true;
+}
+
+// Acrescenta um inteiro de 4 bytes a um vetor de bytes
+static void acrescentar32(std::vector<uint8_t>& V, uint32_t X)
+{
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(&X);
+  V.insert(V.end(), p, p+4);
+}
+
+///
+/// CLASSE ServidorSimulacao
+///
+
+ServidorSimulacao::ServidorSimulacao(): fdEscuta(-1), parando(false) {}
+
+ServidorSimulacao::~ServidorSimulacao()
+{
+  parar();
+  esperarThreads();
+}
+
+// Recolhe as threads das conexoes encerradas (com mtxConexoes travado)
+void ServidorSimulacao::recolherTerminadas()
+{
+  for (std::thread::id Id : terminadas)
+  {
+    auto it = threads.find(Id);
+    if (it==threads.end()) continue;
+    // A thread jah saiu da regiao travada e apenas retorna
+    if (it->second.joinable()) it->second.join();
+    threads.erase(it);
+  }
+  terminadas.clear();
+}
+
+// Espera todas as threads das conexoes
+void ServidorSimulacao::esperarThreads()
+{
+  std::map<std::thread::id, std::thread> todas;
+  {
+    std::lock_guard<std::mutex> L(mtxConexoes);
+    todas.swap(threads);
+    terminadas.clear();
+  }
+  for (auto& T : todas) if (T.second.joinable()) T.second.join();
+}
+
+// Registra uma copia compilada do circuito C com o nome Nome
+bool ServidorSimulacao::registrar(const std::string& Nome, const Circuit& C)
+{
+  if (Nome.empty() || Nome.size()>0xFFFF) return false;
+  std::unique_ptr<CircuitoServido> E(new CircuitoServido);
+  if (!E->N.compilar(C)) return false;
+  E->numPortas = C.getNumPorts();
+  E->ocupado = false;
+  E->sinais.assign(E->N.getNumSinais(), bool3S_64{0,0});
+  E->numPedidos = 0;
+  E->numLotes = 0;
+  circuitos[Nome] = std::move(E);
+  return true;
+}
+
+// Carrega um circuito de arquivo e o registra com o nome Nome
+bool ServidorSimulacao::carregar(const std::string& Nome, const std::string& Arq)
+{
+  Circuit C;
+  size_t ponto = Arq.rfind('.');
+  std::string ext = (ponto==std::string::npos) ? "" : Arq.substr(ponto);
+  bool ok = (ext==".bench" || ext==".blif") ? importarCircuito(Arq, C) : C.ler(Arq);
+  if (!ok || !registrar(Nome, C))
+  {
+    std::cerr << "Circuito " << Nome << " (" << Arq << ") invalido\n";
+    return false;
+  }
+  return true;
+}
+
+// Simula N vetores (N <= 64) com os sinais S
+void ServidorSimulacao::simularPalavra(const Netlist& N, std::vector<bool3S_64>& S,
+                                       const uint8_t* const* In, uint8_t* const* Out, unsigned Num)
+{
+  for (unsigned i=0; i<N.getNumInputs(); i++)
+  {
+    bool3S_64 x{0,0};
+    for (unsigned k=0; k<Num; k++) fixarPista(x, k, bool3S(In[k][i]));
+    S[i] = x;
+  }
+  N.simular(S.data());
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    const bool3S_64& y = S[N.getSaida(j)];
+    for (unsigned k=0; k<Num; k++) Out[k][j] = uint8_t(lerPista(y, k));
+  }
+}
+
+// Simula um vetor, agrupando com os pedidos concorrentes
+void ServidorSimulacao::simularAgrupado(CircuitoServido& E, const uint8_t* In, uint8_t* Out)
+{
+  Pedido P{In, Out, false};
+  const uint8_t* in[64];
+  uint8_t* out[64];
+  std::vector<Pedido*> lote;
+
+  std::unique_lock<std::mutex> L(E.mtx);
+  E.fila.push_back(&P);
+  while (!P.pronto)
+  {
+    if (E.ocupado)
+    {
+      E.cv.wait(L);
+      continue;
+    }
+    // Esta thread simula a fila, em lotes de ate 64 pedidos, ateh ela esvaziar
+    E.ocupado = true;
+    while (!E.fila.empty())
+    {
+      unsigned num = std::min<size_t>(64, E.fila.size());
+      lote.assign(E.fila.begin(), E.fila.begin()+num);
+      E.fila.erase(E.fila.begin(), E.fila.begin()+num);
+      L.unlock();
+      for (unsigned k=0; k<num; k++) {in[k] = lote[k]->in; out[k] = lote[k]->out;}
+      simularPalavra(E.N, E.sinais, in, out, num);
+      L.lock();
+      for (Pedido* Q : lote) Q->pronto = true;
+      E.numPedidos += num;
+      E.numLotes++;
+      E.cv.notify_all();
+    }
+    E.ocupado = false;
+    E.cv.notify_all();
+  }
+}
+
+// Executa um pedido; retorna o status e preenche os dados da resposta
+StatusServidor ServidorSimulacao::executar(OpServidor Op, CircuitoServido& E,
+                                           const std::vector<uint8_t>& Dados,
+                                           std::vector<uint8_t>& Resposta)
+{
+  const Netlist& N = E.N;
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  Resposta.clear();
+  switch (Op)
+  {
+  case OpServidor::INFO:
+    acrescentar32(Resposta, Nin);
+    acrescentar32(Resposta, Nout);
+    acrescentar32(Resposta, E.numPortas);
+    return StatusServidor::OK;
+
+  case OpServidor::SIMULAR:
+    if (Dados.size()!=Nin || !valoresValidos(Dados.data(), Dados.size())) return StatusServidor::PEDIDO_INVALIDO;
+    Resposta.resize(Nout);
+    simularAgrupado(E, Dados.data(), Resposta.data());
+    return StatusServidor::OK;
+
+  case OpServidor::LOTE:
+  {
+    if (Dados.size()<4) return StatusServidor::PEDIDO_INVALIDO;
+    uint32_t num;
+    std::memcpy(&num, Dados.data(), 4);
+    if (Dados.size()-4 != size_t(num)*Nin || !valoresValidos(Dados.data()+4, Dados.size()-4))
+    {
+      return StatusServidor::PEDIDO_INVALIDO;
+    }
+    if (size_t(num)*Nout > MAX_DADOS_PEDIDO) return StatusServidor::PEDIDO_INVALIDO;
+    Resposta.resize(size_t(num)*Nout);
+    std::vector<bool3S_64> S(N.getNumSinais(), bool3S_64{0,0});
+    const uint8_t* in[64];
+    uint8_t* out[64];
+    for (uint32_t v=0; v<num; v+=64)
+    {
+      unsigned k = std::min<uint32_t>(64, num-v);
+      for (unsigned l=0; l<k; l++)
+      {
+        in[l] = Dados.data()+4+size_t(v+l)*Nin;
+        out[l] = Resposta.data()+size_t(v+l)*Nout;
+      }
+      simularPalavra(N, S, in, out, k);
+    }
+    return StatusServidor::OK;
+  }
+
+  case OpServidor::TABELA:
+  {
+    if (Nin>MAX_ENTRADAS_TABELA_SERVIDOR) return StatusServidor::TABELA_GRANDE;
+    size_t linhas = 1;
+    for (unsigned i=0; i<Nin; i++) linhas *= 3;
+    Resposta.resize(linhas*Nout);
+    std::vector<bool3S_64> S(N.getNumSinais(), bool3S_64{0,0});
+    // Linha r: o digito i de r na base 3, a partir da ultima entrada, eh o valor
+    // numerico de bool3S (0: ?; 1: F; 2: T), como na ordem de gerarTabela
+    std::vector<uint8_t> in(64*size_t(Nin));
+    const uint8_t* pin[64];
+    uint8_t* pout[64];
+    for (size_t r0=0; r0<linhas; r0+=64)
+    {
+      unsigned k = unsigned(std::min<size_t>(64, linhas-r0));
+      for (unsigned l=0; l<k; l++)
+      {
+        size_t r = r0+l;
+        for (unsigned i=Nin; i-- > 0; ) {in[l*Nin+i] = uint8_t(r%3); r /= 3;}
+        pin[l] = in.data()+l*Nin;
+        pout[l] = Resposta.data()+(r0+l)*Nout;
+      }
+      simularPalavra(N, S, pin, pout, k);
+    }
+    return StatusServidor::OK;
+  }
+
+  default:
+    return StatusServidor::OP_DESCONHECIDA;
+  }
+}
+
+// Numero total de pedidos SIMULAR atendidos e de lotes simulados para eles
+unsigned long long ServidorSimulacao::getNumPedidos() const
+{
+  unsigned long long N = 0;
+  for (auto& par : circuitos)
+  {
+    std::lock_guard<std::mutex> L(par.second->mtx);
+    N += par.second->numPedidos;
+  }
+  return N;
+}
+
+unsigned long long ServidorSimulacao::getNumLotes() const
+{
+  unsigned long long N = 0;
+  for (auto& par : circuitos)
+  {
+    std::lock_guard<std::mutex> L(par.second->mtx);
+    N += par.second->numLotes;
+  }
+  return N;
+}
+
+#ifndef _WIN32
+
+// Cria o socket no caminho Caminho
+bool ServidorSimulacao::iniciar(const std::string& Caminho)
+{
+  sockaddr_un end;
+  if (Caminho.empty() || Caminho.size()>=sizeof(end.sun_path))
+  {
+    std::cerr << "Caminho de socket invalido: " << Caminho << "\n";
+    return false;
+  }
+  std::memset(&end, 0, sizeof(end));
+  end.sun_family = AF_UNIX;
+  std::strcpy(end.sun_path, Caminho.c_str());
+
+  fdEscuta = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fdEscuta<0)
+  {
+    std::cerr << "Erro ao criar o socket: " << std::strerror(errno) << "\n";
+    return false;
+  }
+  ::unlink(Caminho.c_str());
+  if (::bind(fdEscuta, reinterpret_cast<sockaddr*>(&end), sizeof(end))<0 || ::listen(fdEscuta, 128)<0)
+  {
+    std::cerr << "Erro ao abrir o socket " << Caminho << ": " << std::strerror(errno) << "\n";
+    ::close(fdEscuta);
+    fdEscuta = -1;
+    return false;
+  }
+  caminho = Caminho;
+  parando = false;
+  return true;
+}
+
+// Aceita conexoes ateh receber DESLIGAR ou ateh parar ser chamado
+void ServidorSimulacao::executar()
+{
+  RASTRO_ESCOPO("servidor");
+  while (!parando)
+  {
+    int fd = ::accept(fdEscuta, nullptr, nullptr);
+    if (fd<0)
+    {
+      if (errno==EINTR) continue;
+      break;
+    }
+    std::lock_guard<std::mutex> L(mtxConexoes);
+    if (parando)
+    {
+      ::close(fd);
+      break;
+    }
+    recolherTerminadas();
+    // Sem recursos para uma nova thread: recusa a conexao e continua aceitando
+    try
+    {
+      std::thread T(&ServidorSimulacao::atender, this, fd);
+      std::thread::id id = T.get_id();
+      threads.emplace(id, std::move(T));
+      conexoes.insert(fd);
+    }
+    catch (const std::system_error& E)
+    {
+      std::cerr << "Conexao recusada (erro ao criar a thread): " << E.what() << "\n";
+      ::close(fd);
+    }
+  }
+  parar();
+  esperarThreads();
+  if (fdEscuta>=0)
+  {
+    ::close(fdEscuta);
+    fdEscuta = -1;
+    ::unlink(caminho.c_str());
+  }
+}
+
+// Para o servidor: desbloqueia o accept e as leituras das conexoes abertas
+void ServidorSimulacao::parar()
+{
+  std::lock_guard<std::mutex> L(mtxConexoes);
+  parando = true;
+  if (fdEscuta>=0) ::shutdown(fdEscuta, SHUT_RDWR);
+  for (int fd : conexoes) ::shutdown(fd, SHUT_RDWR);
+}
+
+// Atende os pedidos de uma conexao ateh ela ser fechada
+void ServidorSimulacao::atender(int Fd)
+{
+  std::vector<uint8_t> nome, dados, resposta;
+  uint8_t cab[8];
+  while (!parando && lerTudo(Fd, cab, 8))
+  {
+    OpServidor op = OpServidor(cab[0]);
+    uint16_t tamNome;
+    uint32_t tamDados;
+    std::memcpy(&tamNome, cab+2, 2);
+    std::memcpy(&tamDados, cab+4, 4);
+    if (tamDados>MAX_DADOS_PEDIDO) break;
+    nome.resize(tamNome);
+    dados.resize(tamDados);
+    if (!lerTudo(Fd, nome.data(), tamNome) || !lerTudo(Fd, dados.data(), tamDados)) break;
+
+    StatusServidor status;
+    resposta.clear();
+    if (op==OpServidor::DESLIGAR)
+    {
+      status = StatusServidor::OK;
+    }
+    else
+    {
+      auto it = circuitos.find(std::string(nome.begin(), nome.end()));
+      if (it==circuitos.end()) status = StatusServidor::CIRCUITO_DESCONHECIDO;
+      else status = executar(op, *it->second, dados, resposta);
+    }
+
+    uint8_t cabResp[8] = {uint8_t(status), 0, 0, 0};
+    uint32_t tam = resposta.size();
+    std::memcpy(cabResp+4, &tam, 4);
+    if (!escreverTudo(Fd, cabResp, 8) || !escreverTudo(Fd, resposta.data(), resposta.size())) break;
+    if (op==OpServidor::DESLIGAR) parar();
+  }
+  std::lock_guard<std::mutex> L(mtxConexoes);
+  conexoes.erase(Fd);
+  ::close(Fd);
+  terminadas.push_back(std::this_thread::get_id());
+}
+
+///
+/// CLASSE ClienteSimulacao
+///
+
+bool ClienteSimulacao::conectar(const std::string& Caminho)
+{
+  sockaddr_un end;
+  desconectar();
+  if (Caminho.empty() || Caminho.size()>=sizeof(end.sun_path)) return false;
+  std::memset(&end, 0, sizeof(end));
+  end.sun_family = AF_UNIX;
+  std::strcpy(end.sun_path, Caminho.c_str());
+  fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd<0) return false;
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&end), sizeof(end))<0)
+  {
+    desconectar();
+    return false;
+  }
+  return true;
+}
+
+void ClienteSimulacao::desconectar()
+{
+  if (fd>=0) ::close(fd);
+  fd = -1;
+}
+
+// Envia um pedido e recebe a resposta
+bool ClienteSimulacao::pedir(OpServidor Op, const std::string& Nome, const std::vector<uint8_t>& Dados,
+                             std::vector<uint8_t>& Resposta)
+{
+  if (fd<0 || Nome.size()>0xFFFF) return false;
+  uint8_t cab[8] = {uint8_t(Op), 0};
+  uint16_t tamNome = Nome.size();
+  uint32_t tamDados = Dados.size();
+  std::memcpy(cab+2, &tamNome, 2);
+  std::memcpy(cab+4, &tamDados, 4);
+  if (!escreverTudo(fd, cab, 8) || !escreverTudo(fd, Nome.data(), Nome.size()) ||
+      !escreverTudo(fd, Dados.data(), Dados.size()) || !lerTudo(fd, cab, 8))
+  {
+    desconectar();
+    return false;
+  }
+  std::memcpy(&tamDados, cab+4, 4);
+  Resposta.resize(tamDados);
+  if (!lerTudo(fd, Resposta.data(), tamDados))
+  {
+    desconectar();
+    return false;
+  }
+  return StatusServidor(cab[0])==StatusServidor::OK;
+}
+
+#else // _WIN32
+
+bool ServidorSimulacao::iniciar(const std::string& Caminho)
+{
+  std::cerr << "Servidor de simulacao nao disponivel em Windows\n";
+  return false;
+}
+
+void ServidorSimulacao::executar() {}
+
+void ServidorSimulacao::parar() {parando = true;}
+
+void ServidorSimulacao::atender(int Fd) {}
+
+bool ClienteSimulacao::conectar(const std::string& Caminho) {return false;}
+
+void ClienteSimulacao::desconectar() {fd = -1;}
+
+bool ClienteSimulacao::pedir(OpServidor Op, const std::string& Nome, const std::vector<uint8_t>& Dados,
+                             std::vector<uint8_t>& Resposta)
+{
+  return false;
+}
+
+#endif // _WIN32
+
+// Dimensoes do circuito Nome
+bool ClienteSimulacao::info(const std::string& Nome, unsigned& Nin, unsigned& Nout, unsigned& Nportas)
+{
+  std::vector<uint8_t> resp;
+  if (!pedir(OpServidor::INFO, Nome, std::vector<uint8_t>(), resp) || resp.size()!=12) return false;
+  uint32_t x[3];
+  std::memcpy(x, resp.data(), 12);
+  Nin = x[0];
+  Nout = x[1];
+  Nportas = x[2];
+  return true;
+}
+
+// Simula um vetor de entradas
+bool ClienteSimulacao::simular(const std::string& Nome, const std::vector<bool3S>& In, std::vector<bool3S>& Out)
+{
+  std::vector<uint8_t> dados(In.size()), resp;
+  for (size_t i=0; i<In.size(); i++) dados[i] = uint8_t(In[i]);
+  if (!pedir(OpServidor::SIMULAR, Nome, dados, resp)) return false;
+  Out.resize(resp.size());
+  for (size_t j=0; j<resp.size(); j++) Out[j] = bool3S(resp[j]);
+  return true;
+}
+
+// Simula varios vetores de entradas
+bool ClienteSimulacao::simular(const std::string& Nome, const std::vector<std::vector<bool3S>>& In,
+                               std::vector<std::vector<bool3S>>& Out)
+{
+  std::vector<uint8_t> dados, resp;
+  acrescentar32(dados, In.size());
+  for (const std::vector<bool3S>& V : In)
+  {
+    for (bool3S x : V) dados.push_back(uint8_t(x));
+  }
+  if (!pedir(OpServidor::LOTE, Nome, dados, resp)) return false;
+  Out.assign(In.size(), std::vector<bool3S>());
+  if (In.empty()) return true;
+  size_t Nout = resp.size()/In.size();
+  for (size_t k=0; k<In.size(); k++)
+  {
+    Out[k].resize(Nout);
+    for (size_t j=0; j<Nout; j++) Out[k][j] = bool3S(resp[k*Nout+j]);
+  }
+  return true;
+}
+
+// Saidas de todas as linhas da tabela verdade
+bool ClienteSimulacao::tabela(const std::string& Nome, std::vector<std::vector<bool3S>>& Out)
+{
+  unsigned Nin, Nout, Nportas;
+  std::vector<uint8_t> resp;
+  if (!info(Nome, Nin, Nout, Nportas)) return false;
+  if (!pedir(OpServidor::TABELA, Nome, std::vector<uint8_t>(), resp)) return false;
+  Out.assign(Nout==0 ? 0 : resp.size()/Nout, std::vector<bool3S>(Nout));
+  for (size_t k=0; k<Out.size(); k++)
+  {
+    for (size_t j=0; j<Nout; j++) Out[k][j] = bool3S(resp[k*Nout+j]);
+  }
+  return true;
+}
+
+// Pede ao servidor que pare
+bool ClienteSimulacao::desligar()
+{
+  std::vector<uint8_t> resp;
+  return pedir(OpServidor::DESLIGAR, "", std::vector<uint8_t>(), resp);
+}
@@ -0,0 +1,166 @@
+#ifndef _SERVIDOR_H_
+#define _SERVIDOR_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SERVIDOR DE SIMULACAO (socket Unix local, protocolo binario)
+///
+
+// O servidor mantem na memoria circuitos com nome, compilados uma unica vez, e atende
+// pedidos de simulacao em um socket Unix (AF_UNIX, SOCK_STREAM), uma thread por conexao.
+// Cada conexao pode enviar qualquer numero de pedidos, um depois do outro.
+//
+// Pedido:   [op: 1 byte] [0: 1 byte] [tamanho do nome: 2 bytes] [tamanho dos dados: 4 bytes]
+//           [nome] [dados]
+// Resposta: [status: 1 byte] [0: 3 bytes] [tamanho dos dados: 4 bytes] [dados]
+// Os inteiros estao na ordem de bytes da maquina (o socket eh local). Os valores logicos
+// ocupam um byte cada, com o valor numerico de bool3S (0: ?; 1: F; 2: T).
+//
+// Operacoes (dados do pedido -> dados da resposta):
+// - SIMULAR:  Nin valores -> Nout valores
+// - LOTE:     [N: 4 bytes] N*Nin valores -> N*Nout valores
+// - TABELA:   nada -> as saidas das 3^Nin linhas da tabela verdade, na ordem de
+//             gerarTabela (3^Nin*Nout valores); no maximo MAX_ENTRADAS_TABELA_SERVIDOR entradas
+// - INFO:     nada -> [Nin] [Nout] [Nportas] (4 bytes cada)
+// - DESLIGAR: nada -> nada (o servidor para de aceitar conexoes e encerra as existentes)
+//
+// Pedidos SIMULAR concorrentes para o mesmo circuito sao agrupados em lotes de ate 64
+// vetores, simulados de uma vez (bool3S_64): a primeira thread que encontra o circuito
+// livre simula os pedidos pendentes, em lotes, ateh a fila esvaziar, enquanto as outras
+// esperam pelo resultado. Os pedidos LOTE e TABELA sao simulados 64 vetores por vez
+// pela propria thread da conexao.
+//
+// Os flip-flops, se houver, ficam com estado UNDEF. Em Windows, o servidor e o cliente
+// nao estao disponiveis (iniciar e conectar retornam false).
+
+// Codigos de operacao
+enum class OpServidor : uint8_t {SIMULAR=1, LOTE=2, TABELA=3, INFO=4, DESLIGAR=9};
+
+// Codigos de status das respostas
+enum class StatusServidor : uint8_t {OK=0, CIRCUITO_DESCONHECIDO=1, PEDIDO_INVALIDO=2,
+                                     OP_DESCONHECIDA=3, TABELA_GRANDE=4};
+
+// Numero maximo de entradas para a operacao TABELA
+const unsigned MAX_ENTRADAS_TABELA_SERVIDOR = 12;
+
+class ServidorSimulacao {
+private:
+  // Um pedido SIMULAR pendente
+  struct Pedido {
+    const uint8_t* in;
+    uint8_t* out;
+    bool pronto;
+  };
+
+  // Um circuito carregado, com a fila de pedidos SIMULAR
+  struct CircuitoServido {
+    Netlist N;
+    unsigned numPortas;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<Pedido*> fila;
+    // Alguma thread esta simulando os pedidos da fila
+    bool ocupado;
+    // Sinais usados pela thread que simula a fila
+    std::vector<bool3S_64> sinais;
+    // Estatisticas de agrupamento
+    unsigned long long numPedidos;
+    unsigned long long numLotes;
+  };
+
+  // Os circuitos sao carregados antes de iniciar e nao mudam durante o atendimento
+  std::map<std::string, std::unique_ptr<CircuitoServido>> circuitos;
+  std::string caminho;
+  int fdEscuta;
+  std::atomic<bool> parando;
+  // Conexoes abertas (para encerra-las ao parar) e suas threads; as threads das conexoes
+  // encerradas ficam em terminadas ateh serem recolhidas (join) pelo laco de accept
+  std::mutex mtxConexoes;
+  std::set<int> conexoes;
+  std::map<std::thread::id, std::thread> threads;
+  std::vector<std::thread::id> terminadas;
+
+  // Recolhe as threads das conexoes encerradas (com mtxConexoes travado)
+  void recolherTerminadas();
+  // Espera todas as threads das conexoes
+  void esperarThreads();
+
+  // Atende os pedidos de uma conexao ateh ela ser fechada
+  void atender(int Fd);
+  // Executa um pedido; retorna o status e preenche os dados da resposta
+  StatusServidor executar(OpServidor Op, CircuitoServido& E, const std::vector<uint8_t>& Dados,
+                          std::vector<uint8_t>& Resposta);
+  // Simula um vetor, agrupando com os pedidos concorrentes
+  void simularAgrupado(CircuitoServido& E, const uint8_t* In, uint8_t* Out);
+  // Simula N vetores (N <= 64) com os sinais S
+  static void simularPalavra(const Netlist& N, std::vector<bool3S_64>& S,
+                             const uint8_t* const* In, uint8_t* const* Out, unsigned Num);
+
+public:
+  ServidorSimulacao();
+  ~ServidorSimulacao();
+
+  // Carrega um circuito de arquivo (formato do projeto ou, pela extensao, .bench/.blif)
+  // e o registra com o nome Nome. Retorna false se o arquivo ou o circuito for invalido.
+  bool carregar(const std::string& Nome, const std::string& Arq);
+  // Registra uma copia compilada do circuito C com o nome Nome
+  bool registrar(const std::string& Nome, const Circuit& C);
+  unsigned getNumCircuitos() const {return circuitos.size();}
+
+  // Cria o socket no caminho Caminho (removendo um arquivo anterior com esse nome)
+  // Retorna false (com uma mensagem em cerr) se nao conseguir
+  bool iniciar(const std::string& Caminho);
+  // Aceita conexoes ateh receber DESLIGAR ou ateh parar ser chamado
+  void executar();
+  // Para o servidor (pode ser chamado de outra thread)
+  void parar();
+
+  // Numero total de pedidos SIMULAR atendidos e de lotes simulados para eles
+  unsigned long long getNumPedidos() const;
+  unsigned long long getNumLotes() const;
+};
+
+// Cliente do servidor de simulacao (uma conexao; nao deve ser usado por varias threads)
+class ClienteSimulacao {
+private:
+  int fd;
+
+  // Envia um pedido e recebe a resposta; retorna false em erro de comunicacao ou status != OK
+  bool pedir(OpServidor Op, const std::string& Nome, const std::vector<uint8_t>& Dados,
+             std::vector<uint8_t>& Resposta);
+
+public:
+  ClienteSimulacao(): fd(-1) {}
+  ~ClienteSimulacao() {desconectar();}
+
+  bool conectar(const std::string& Caminho);
+  void desconectar();
+
+  // Dimensoes do circuito Nome
+  bool info(const std::string& Nome, unsigned& Nin, unsigned& Nout, unsigned& Nportas);
+  // Simula um vetor de entradas
+  bool simular(const std::string& Nome, const std::vector<bool3S>& In, std::vector<bool3S>& Out);
+  // Simula varios vetores de entradas
+  bool simular(const std::string& Nome, const std::vector<std::vector<bool3S>>& In,
+               std::vector<std::vector<bool3S>>& Out);
+  // Saidas de todas as linhas da tabela verdade
+  bool tabela(const std::string& Nome, std::vector<std::vector<bool3S>>& Out);
+  // Pede ao servidor que pare
+  bool desligar();
+};
+
+#endif // _SERVIDOR_H_
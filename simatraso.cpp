@@ -0,0 +1,201 @@
+#include "simatraso.h"
+#include "rastro.h"
+
+// Atraso padrao de cada tipo de porta (na ordem de TipoPorta: NT, AN, NA, OR, NO, XO, NX, FF)
+// (a saida de um flip-flop nao muda durante a simulacao de um vetor)
+static const unsigned atrasoPadrao[] = {1, 2, 1, 2, 1, 3, 3, 1};
+
+///
+/// CLASSE SimuladorAtraso
+///
+
+/// ***********************
+/// Inicializacao
+/// ***********************
+
+SimuladorAtraso::SimuladorAtraso():
+  pendentes(0), numMarca(0), primeiro(true), tempoFinal(0), numEventos(0) {}
+
+// Compila o circuito; os atrasos iniciais sao os atrasos padrao de cada tipo de porta
+bool SimuladorAtraso::inicializar(const Circuit& C)
+{
+  if (!N.compilar(C)) return false;
+  atraso.resize(N.getNumPorts());
+  for (unsigned p=0; p<N.getNumPorts(); p++) atraso[p] = atrasoPadrao[unsigned(N.getTipo(p))];
+  marca.assign(N.getNumPorts(), 0);
+  numMarca = 0;
+  acomodacao.assign(N.getNumOutputs(), 0);
+  mudancas.assign(N.getNumOutputs(), 0);
+  inicial.assign(N.getNumOutputs(), bool3S::UNDEF);
+  inicioSaidas.assign(N.getNumSinais()+1, 0);
+  for (unsigned j=0; j<N.getNumOutputs(); j++) inicioSaidas[N.getSaida(j)+1]++;
+  for (unsigned S=0; S<N.getNumSinais(); S++) inicioSaidas[S+1] += inicioSaidas[S];
+  saidasSinal.resize(N.getNumOutputs());
+  {
+    std::vector<unsigned> pos(inicioSaidas.begin(), inicioSaidas.end()-1);
+    for (unsigned j=0; j<N.getNumOutputs(); j++) saidasSinal[pos[N.getSaida(j)]++] = j;
+  }
+  dimensionarRoda();
+  reset();
+  return true;
+}
+
+// Fixa o atraso (>= 1) de todas as portas do tipo T
+void SimuladorAtraso::setAtrasoTipo(TipoPorta T, unsigned D)
+{
+  if (D==0) return;
+  for (unsigned p=0; p<N.getNumPorts(); p++) if (N.getTipo(p)==T) atraso[p] = D;
+  dimensionarRoda();
+}
+
+// Fixa o atraso (>= 1) da porta de id IdPort
+void SimuladorAtraso::setAtrasoPorta(int IdPort, unsigned D)
+{
+  if (D==0 || IdPort<1 || IdPort>int(N.getNumPorts())) return;
+  atraso[IdPort-1] = D;
+  dimensionarRoda();
+}
+
+// Volta todos os sinais para UNDEF
+void SimuladorAtraso::reset()
+{
+  valor.assign(N.getNumSinais(), bool3S::UNDEF);
+  agendado.assign(N.getNumPorts(), bool3S::UNDEF);
+  primeiro = true;
+}
+
+// Ajusta o tamanho da roda ao maior atraso
+// (soh eh chamada entre simulacoes, quando a roda esta vazia)
+void SimuladorAtraso::dimensionarRoda()
+{
+  unsigned maior = 1;
+  for (unsigned d : atraso) if (d>maior) maior = d;
+  unsigned tam = 2;
+  while (tam<=maior) tam *= 2;
+  if (tam!=roda.size()) roda.assign(tam, std::vector<Evento>());
+}
+
+// Marca as portas alimentadas pelo sinal S para reavaliacao
+void SimuladorAtraso::marcarFanout(unsigned S)
+{
+  const unsigned* F = N.getFanout(S);
+  for (unsigned k=0; k<N.getNumFanout(S); k++)
+  {
+    if (marca[F[k]]!=numMarca)
+    {
+      marca[F[k]] = numMarca;
+      reavaliar.push_back(F[k]);
+    }
+  }
+}
+
+// Atribui um novo valor ao sinal S no instante T
+void SimuladorAtraso::mudarSinal(unsigned S, bool3S V, unsigned long long T)
+{
+  if (valor[S]==V) return;
+  valor[S] = V;
+  marcarFanout(S);
+  for (unsigned k=inicioSaidas[S]; k<inicioSaidas[S+1]; k++)
+  {
+    mudancas[saidasSinal[k]]++;
+    acomodacao[saidasSinal[k]] = T;
+  }
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+// Aplica um vetor de entradas no instante 0 e simula ateh nao haver mais eventos
+bool SimuladorAtraso::simular(const std::vector<bool3S>& in_circ)
+{
+  if (in_circ.size()!=N.getNumInputs() || N.getNumPorts()==0) return false;
+  RASTRO_ESCOPO("simular com atrasos");
+  if (N.realimentada() && !primeiro) reset();
+  primeiro = false;
+
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    inicial[j] = valor[N.getSaida(j)];
+    mudancas[j] = 0;
+    acomodacao[j] = 0;
+  }
+  numEventos = 0;
+  tempoFinal = 0;
+
+  const unsigned long long mascara = roda.size()-1;
+  const unsigned Nin = N.getNumInputs();
+  std::vector<bool3S> in_port;
+
+  // Instante 0: mudancas das entradas do circuito
+  numMarca++;
+  reavaliar.clear();
+  for (unsigned i=0; i<Nin; i++) mudarSinal(i, in_circ[i], 0);
+
+  unsigned long long t = 0;
+  while (true)
+  {
+    // Reavalia as portas afetadas no instante t e agenda as mudancas das saidas
+    for (unsigned p : reavaliar)
+    {
+      const unsigned* e = N.getEntradas(p);
+      unsigned NI = N.getNumInputsPort(p);
+      in_port.resize(NI);
+      for (unsigned j=0; j<NI; j++) in_port[j] = valor[e[j]];
+      bool3S v = avaliarPorta(N.getTipo(p), in_port.data(), NI);
+      if (v!=agendado[p])
+      {
+        agendado[p] = v;
+        roda[(t+atraso[p]) & mascara].push_back({p, v});
+        pendentes++;
+      }
+    }
+    if (pendentes==0) break;
+
+    // Avanca para o proximo instante e aplica os eventos do balde
+    t++;
+    numMarca++;
+    reavaliar.clear();
+    std::vector<Evento>& balde = roda[t & mascara];
+    if (balde.empty()) continue;
+    for (const Evento& E : balde) mudarSinal(Nin+E.porta, E.valor, t);
+    numEventos += balde.size();
+    pendentes -= balde.size();
+    balde.clear();
+    tempoFinal = t;
+  }
+  return true;
+}
+
+/// ***********************
+/// Funcoes de consulta
+/// ***********************
+
+// Valor final da saida de id IdOutput
+bool3S SimuladorAtraso::getOutput(int IdOutput) const
+{
+  if (IdOutput<1 || IdOutput>int(N.getNumOutputs())) return bool3S::UNDEF;
+  return valor[N.getSaida(IdOutput-1)];
+}
+
+// Instante da ultima mudanca da saida de id IdOutput (0 se nao mudou)
+unsigned long long SimuladorAtraso::getAcomodacao(int IdOutput) const
+{
+  if (IdOutput<1 || IdOutput>int(N.getNumOutputs())) return 0;
+  return acomodacao[IdOutput-1];
+}
+
+// Numero de mudancas da saida de id IdOutput
+unsigned SimuladorAtraso::getMudancas(int IdOutput) const
+{
+  if (IdOutput<1 || IdOutput>int(N.getNumOutputs())) return 0;
+  return mudancas[IdOutput-1];
+}
+
+// Numero de glitches da saida de id IdOutput
+unsigned SimuladorAtraso::getGlitches(int IdOutput) const
+{
+  if (IdOutput<1 || IdOutput>int(N.getNumOutputs())) return 0;
+  unsigned necessarias = (inicial[IdOutput-1]!=getOutput(IdOutput)) ? 1 : 0;
+  return mudancas[IdOutput-1]-necessarias;
+}
@@ -0,0 +1,116 @@
+#ifndef _SIMATRASO_H_
+#define _SIMATRASO_H_
+
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SIMULACAO COM ATRASOS (dirigida por eventos, com roda de tempo)
+///
+
+// Cada porta tem um atraso de propagacao inteiro (>= 1), definido por tipo de porta
+// ou por porta. Quando uma entrada de uma porta muda no instante t, a porta eh
+// reavaliada e, se o novo valor difere do ultimo valor agendado, a mudanca da saida eh
+// agendada para o instante t+atraso (atraso de transporte).
+//
+// Os eventos ficam em uma roda de tempo: um vetor circular de baldes com tamanho
+// (potencia de 2) maior que o maior atraso. Inserir um evento e avancar o tempo sao O(1).
+//
+// A cada vetor de entradas aplicado (no instante 0), simula ateh nao haver mais eventos
+// e registra, para cada saida do circuito, o instante da ultima mudanca (tempo de
+// acomodacao), o numero de mudancas e o numero de glitches (mudancas alem da necessaria
+// para ir do valor inicial ao final).
+//
+// O estado de partida de cada vetor eh o estado acomodado do vetor anterior, de modo que
+// os glitches refletem a transicao entre vetores consecutivos. Em circuitos com lacos de
+// realimentacao, todos os sinais voltam a UNDEF antes de cada vetor, como em Circuit::simular.
+// Em ambos os casos, os valores finais sao os mesmos da simulacao sem atrasos.
+class SimuladorAtraso {
+private:
+  struct Evento {
+    unsigned porta;
+    bool3S valor;
+  };
+
+  Netlist N;
+  // Atraso de cada porta
+  std::vector<unsigned> atraso;
+  // Valor atual de cada sinal e ultimo valor agendado de cada porta
+  std::vector<bool3S> valor;
+  std::vector<bool3S> agendado;
+  // Roda de tempo
+  std::vector<std::vector<Evento>> roda;
+  unsigned long long pendentes;
+  // Portas a reavaliar no instante atual (e marcas para nao repetir)
+  std::vector<unsigned> reavaliar;
+  std::vector<unsigned long long> marca;
+  unsigned long long numMarca;
+  bool primeiro;
+
+  // Estatisticas do ultimo vetor simulado
+  std::vector<unsigned long long> acomodacao;
+  std::vector<unsigned> mudancas;
+  std::vector<bool3S> inicial;
+  // Saidas do circuito ligadas ao sinal S: saidasSinal[inicioSaidas[S]] ateh
+  // saidasSinal[inicioSaidas[S+1]-1] (varias saidas podem vir do mesmo sinal)
+  std::vector<unsigned> inicioSaidas;
+  std::vector<unsigned> saidasSinal;
+  unsigned long long tempoFinal;
+  unsigned long long numEventos;
+
+  // Ajusta o tamanho da roda ao maior atraso
+  void dimensionarRoda();
+  // Marca as portas alimentadas pelo sinal S para reavaliacao
+  void marcarFanout(unsigned S);
+  // Atribui um novo valor ao sinal S no instante T
+  void mudarSinal(unsigned S, bool3S V, unsigned long long T);
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  SimuladorAtraso();
+
+  // Compila o circuito; os atrasos iniciais sao os atrasos padrao de cada tipo de porta
+  // (NT, NA, NO: 1; AN, OR: 2; XO, NX: 3)
+  // Retorna false se o circuito nao for valido
+  bool inicializar(const Circuit& C);
+
+  // Fixa o atraso (>= 1) de todas as portas do tipo T
+  void setAtrasoTipo(TipoPorta T, unsigned D);
+  // Fixa o atraso (>= 1) da porta de id IdPort
+  void setAtrasoPorta(int IdPort, unsigned D);
+  // Volta todos os sinais para UNDEF
+  void reset();
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Aplica um vetor de entradas no instante 0 e simula ateh nao haver mais eventos
+  // Retorna false se a dimensao da entrada for invalida
+  bool simular(const std::vector<bool3S>& in_circ);
+
+  /// ***********************
+  /// Funcoes de consulta (resultados do ultimo vetor simulado)
+  /// ***********************
+
+  // Valor final da saida de id IdOutput
+  bool3S getOutput(int IdOutput) const;
+  // Instante da ultima mudanca da saida de id IdOutput (0 se nao mudou)
+  unsigned long long getAcomodacao(int IdOutput) const;
+  // Numero de mudancas da saida de id IdOutput
+  unsigned getMudancas(int IdOutput) const;
+  // Numero de glitches da saida de id IdOutput
+  unsigned getGlitches(int IdOutput) const;
+  // Instante do ultimo evento processado
+  unsigned long long getTempoFinal() const {return tempoFinal;}
+  // Numero de eventos processados
+  unsigned long long getNumEventos() const {return numEventos;}
+};
+
+#endif // _SIMATRASO_H_
@@ -0,0 +1,102 @@
+#include "simciclo.h"
+#include "rastro.h"
+
+///
+/// CLASSE SimuladorCiclos
+///
+
+/// ***********************
+/// Inicializacao
+/// ***********************
+
+SimuladorCiclos::SimuladorCiclos(): numCiclos(0) {}
+
+// Compila o circuito e volta todos os flip-flops para UNDEF
+bool SimuladorCiclos::inicializar(const Circuit& C)
+{
+  if (!N.compilar(C)) return false;
+  sinais.assign(N.getNumSinais(), bool3S_64{0,0});
+  proximo.resize(N.getFlipFlops().size());
+  numCiclos = 0;
+  return true;
+}
+
+// Volta todos os flip-flops para UNDEF
+void SimuladorCiclos::reset()
+{
+  for (unsigned p : N.getFlipFlops()) sinais[N.getNumInputs()+p] = bool3S_64{0,0};
+}
+
+// Fixa o estado de todos os flip-flops (vetor de reset)
+bool SimuladorCiclos::reset(const std::vector<bool3S>& Estado)
+{
+  const std::vector<unsigned>& ff = N.getFlipFlops();
+  if (Estado.size()!=ff.size()) return false;
+  for (unsigned i=0; i<ff.size(); i++) sinais[N.getNumInputs()+ff[i]] = difundir(Estado[i]);
+  return true;
+}
+
+// Armazena nos flip-flops os valores das entradas D
+// (primeiro le todas as entradas, pois a entrada D de um flip-flop pode ser a saida de outro)
+void SimuladorCiclos::bordaClock()
+{
+  const std::vector<unsigned>& ff = N.getFlipFlops();
+  for (unsigned i=0; i<ff.size(); i++) proximo[i] = sinais[N.getEntradas(ff[i])[0]];
+  for (unsigned i=0; i<ff.size(); i++) sinais[N.getNumInputs()+ff[i]] = proximo[i];
+}
+
+/// ***********************
+/// SIMULACAO
+/// ***********************
+
+// Simula um ciclo para as 64 copias do circuito
+void SimuladorCiclos::ciclo(const bool3S_64* In, bool3S_64* Out)
+{
+  for (unsigned i=0; i<N.getNumInputs(); i++) sinais[i] = In[i];
+  N.simular(sinais.data());
+  if (Out!=nullptr)
+  {
+    for (unsigned j=0; j<N.getNumOutputs(); j++) Out[j] = sinais[N.getSaida(j)];
+  }
+  bordaClock();
+  numCiclos++;
+}
+
+// Simula um ciclo com o vetor de entradas in_circ
+bool SimuladorCiclos::ciclo(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ)
+{
+  if (in_circ.size()!=N.getNumInputs() || N.getNumPorts()==0) return false;
+  for (unsigned i=0; i<N.getNumInputs(); i++) sinais[i] = difundir(in_circ[i]);
+  N.simular(sinais.data());
+  out_circ.resize(N.getNumOutputs());
+  for (unsigned j=0; j<N.getNumOutputs(); j++) out_circ[j] = lerPista(sinais[N.getSaida(j)], 0);
+  bordaClock();
+  numCiclos++;
+  return true;
+}
+
+// Simula uma sequencia de ciclos a partir do estado atual
+bool SimuladorCiclos::simular(const std::vector<std::vector<bool3S>>& Entradas,
+                              std::vector<std::vector<bool3S>>& Saidas)
+{
+  RASTRO_ESCOPO("simular ciclos");
+  Saidas.resize(Entradas.size());
+  for (unsigned k=0; k<Entradas.size(); k++)
+  {
+    if (!ciclo(Entradas[k], Saidas[k])) return false;
+  }
+  return true;
+}
+
+/// ***********************
+/// Funcoes de consulta
+/// ***********************
+
+// Estado atual dos flip-flops (pista 0)
+std::vector<bool3S> SimuladorCiclos::getEstado() const
+{
+  const std::vector<unsigned>& ff = N.getFlipFlops();
+  std::vector<bool3S> E(ff.size());
+  for (unsigned i=0; i<ff.size(); i++) E[i] = lerPista(sinais[N.getNumInputs()+ff[i]], 0);
+  return E;
+}
@@ -0,0 +1,88 @@
+#ifndef _SIMCICLO_H_
+#define _SIMCICLO_H_
+
+#include <vector>
+#include "bool3S.h"
+#include "bool3S_64.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SIMULACAO BASEADA EM CICLOS DE CIRCUITOS SEQUENCIAIS
+///
+
+// A cada ciclo de clock, a logica combinacional eh avaliada uma unica vez, na ordem de
+// avaliacao da netlist (os flip-flops sao fontes de sinal com o valor do estado atual) e,
+// em seguida, todos os flip-flops armazenam o valor das suas entradas D.
+// As saidas de um ciclo sao as calculadas antes da borda do clock, como em Circuit::clock.
+//
+// O estado eh empacotado em palavras bool3S_64: cada pista eh uma copia independente do
+// circuito, de modo que 64 sequencias de entrada podem ser simuladas ao mesmo tempo.
+// As funcoes com vetores de bool3S usam a mesma entrada em todas as pistas.
+//
+// Os lacos de realimentacao devem passar por flip-flops. Se sobrar algum laco
+// combinacional, ele eh resolvido em cada ciclo pelo ponto fixo de Netlist::simular.
+class SimuladorCiclos {
+private:
+  Netlist N;
+  // Valores de todos os sinais; os sinais dos flip-flops guardam o estado atual
+  std::vector<bool3S_64> sinais;
+  // Proximo estado de cada flip-flop (na ordem de N.getFlipFlops())
+  std::vector<bool3S_64> proximo;
+  unsigned long long numCiclos;
+
+  // Armazena nos flip-flops os valores das entradas D
+  void bordaClock();
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  SimuladorCiclos();
+
+  // Compila o circuito e volta todos os flip-flops para UNDEF
+  // Retorna false se o circuito nao for valido
+  bool inicializar(const Circuit& C);
+
+  // Volta todos os flip-flops para UNDEF
+  void reset();
+  // Fixa o estado de todos os flip-flops (vetor de reset, na ordem das ids dos flip-flops)
+  // Retorna false se a dimensao do vetor for invalida
+  bool reset(const std::vector<bool3S>& Estado);
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Simula um ciclo com o vetor de entradas in_circ; out_circ recebe as saidas do ciclo
+  // Retorna false se a dimensao da entrada for invalida
+  bool ciclo(const std::vector<bool3S>& in_circ, std::vector<bool3S>& out_circ);
+
+  // Simula um ciclo para as 64 copias do circuito
+  // In deve ter getNumInputs() elementos; Out (se != nullptr), getNumOutputs()
+  void ciclo(const bool3S_64* In, bool3S_64* Out=nullptr);
+
+  // Simula uma sequencia de ciclos a partir do estado atual
+  // Saidas recebe as saidas de cada ciclo
+  // Retorna false se a dimensao de alguma entrada for invalida
+  bool simular(const std::vector<std::vector<bool3S>>& Entradas,
+               std::vector<std::vector<bool3S>>& Saidas);
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumInputs() const {return N.getNumInputs();}
+  unsigned getNumOutputs() const {return N.getNumOutputs();}
+  unsigned getNumFlipFlops() const {return N.getFlipFlops().size();}
+  // Numero de ciclos simulados desde a inicializacao
+  unsigned long long getNumCiclos() const {return numCiclos;}
+
+  // Estado atual dos flip-flops (pista 0), na ordem das ids dos flip-flops
+  std::vector<bool3S> getEstado() const;
+  // Estado atual do flip-flop I (de 0 a getNumFlipFlops()-1) nas 64 pistas
+  const bool3S_64& getEstado64(unsigned I) const {return sinais[N.getNumInputs()+N.getFlipFlops()[I]];}
+};
+
+#endif // _SIMCICLO_H_
@@ -0,0 +1,128 @@
+#include "simconcorrente.h"
+
+///
+/// CLASSE SimuladorConcorrente
+///
+
+SimuladorConcorrente::SimuladorConcorrente(): SimuladorFalhas() {}
+
+bool SimuladorConcorrente::inicializar(const Circuit& C)
+{
+  if (!SimuladorFalhas::inicializar(C)) return false;
+  inicioLista.assign(N.getNumSinais(), 0);
+  fimLista.assign(N.getNumSinais(), 0);
+  bom.assign(N.getNumSinais(), bool3S::UNDEF);
+  pool.clear();
+  return true;
+}
+
+// Simula um vetor de entradas para todas as falhas ainda nao detectadas
+// A lista de falhas montada por SimuladorFalhas::inicializar tem, para o sinal S,
+// a falha stuck-at-0 no indice 2*S e a stuck-at-1 no indice 2*S+1.
+unsigned SimuladorConcorrente::simular(const std::vector<bool3S>& in_circ)
+{
+  if (N.realimentada()) return SimuladorFalhas::simular(in_circ);
+  if (in_circ.size()!=N.getNumInputs() || falhas.empty()) return 0;
+  numVetores++;
+
+  // Circuito sem falha
+  for (unsigned i=0; i<N.getNumInputs(); i++) sinais[i] = difundir(in_circ[i]);
+  for (unsigned p : N.getFlipFlops()) sinais[N.getNumInputs()+p] = bool3S_64{0,0};
+  N.simular(sinais.data());
+  for (unsigned s=0; s<N.getNumSinais(); s++) bom[s] = lerPista(sinais[s], 0);
+
+  pool.clear();
+
+  // Falhas locais do sinal S (ainda nao detectadas) cujo valor difere do valor sem falha
+  // As duas falhas de S tem indices consecutivos, entao a lista continua ordenada
+  auto falhasLocais = [&](unsigned S)
+  {
+    if (detectadaPor[2*S]==0 && bom[S]!=bool3S::FALSE) pool.push_back({2*S, bool3S::FALSE});
+    if (detectadaPor[2*S+1]==0 && bom[S]!=bool3S::TRUE) pool.push_back({2*S+1, bool3S::TRUE});
+  };
+
+  // Entradas do circuito: apenas as falhas locais
+  for (unsigned s=0; s<N.getNumInputs(); s++)
+  {
+    inicioLista[s] = pool.size();
+    falhasLocais(s);
+    fimLista[s] = pool.size();
+  }
+
+  // Portas, na ordem de avaliacao
+  std::vector<unsigned> pos;
+  std::vector<bool3S> in_port;
+  for (unsigned p : N.getOrdem())
+  {
+    const unsigned NI = N.getNumInputsPort(p);
+    const unsigned* e = N.getEntradas(p);
+    const unsigned s = N.getNumInputs()+p;
+    const unsigned local0 = 2*s;
+    // Flip-flops: sao fontes de sinal (com estado UNDEF), como as entradas
+    if (N.getTipo(p)==TipoPorta::FF)
+    {
+      inicioLista[s] = pool.size();
+      falhasLocais(s);
+      fimLista[s] = pool.size();
+      continue;
+    }
+    pos.resize(NI);
+    in_port.resize(NI);
+    for (unsigned j=0; j<NI; j++) pos[j] = inicioLista[e[j]];
+
+    inicioLista[s] = pool.size();
+    bool locaisFeitas = false;
+    // Percorre as falhas das listas das entradas em ordem crescente (intercalacao)
+    while (true)
+    {
+      unsigned f = ~0u;
+      for (unsigned j=0; j<NI; j++)
+      {
+        if (pos[j]<fimLista[e[j]] && pool[pos[j]].falha<f) f = pool[pos[j]].falha;
+      }
+      // As falhas locais entram na posicao certa da ordem
+      if (!locaisFeitas && local0<f)
+      {
+        falhasLocais(s);
+        locaisFeitas = true;
+      }
+      if (f==~0u) break;
+      // Valores das entradas no circuito com a falha f
+      for (unsigned j=0; j<NI; j++)
+      {
+        if (pos[j]<fimLista[e[j]] && pool[pos[j]].falha==f) in_port[j] = pool[pos[j]++].valor;
+        else in_port[j] = bom[e[j]];
+      }
+      // (uma falha local de s nao pode estar nas entradas de s, pois nao ha lacos)
+      bool3S v = avaliarPorta(N.getTipo(p), in_port.data(), NI);
+      if (v!=bom[s]) pool.push_back({f, v});
+    }
+    fimLista[s] = pool.size();
+  }
+
+  // Deteccao: divergencias definidas nas saidas com valor sem falha definido
+  unsigned novas = 0;
+  for (unsigned j=0; j<N.getNumOutputs(); j++)
+  {
+    unsigned s = N.getSaida(j);
+    if (bom[s]==bool3S::UNDEF) continue;
+    for (unsigned k=inicioLista[s]; k<fimLista[s]; k++)
+    {
+      const Divergencia& D = pool[k];
+      if (D.valor!=bool3S::UNDEF && detectadaPor[D.falha]==0)
+      {
+        detectadaPor[D.falha] = numVetores;
+        novas++;
+      }
+    }
+  }
+  numDetectadas += novas;
+  return novas;
+}
+
+// Numero medio de divergencias por sinal no ultimo vetor simulado
+double SimuladorConcorrente::divergenciasPorSinal() const
+{
+  if (N.getNumSinais()==0) return 0.0;
+  return double(pool.size())/N.getNumSinais();
+}
@@ -0,0 +1,55 @@
+#ifndef _SIMCONCORRENTE_H_
+#define _SIMCONCORRENTE_H_
+
+#include <vector>
+#include "simfalhas.h"
+
+///
+/// SIMULACAO CONCORRENTE (DIRIGIDA POR EVENTOS) DE FALHAS STUCK-AT
+///
+
+// Em vez de simular grupos de 63 circuitos com falha inteiros (como SimuladorFalhas),
+// simula o circuito sem falha uma vez por vetor e propaga, porta a porta na ordem de
+// avaliacao, apenas as divergencias: a lista de cada sinal contem as falhas (ainda nao
+// detectadas) para as quais o valor do sinal no circuito com falha difere do valor no
+// circuito sem falha. Uma porta soh eh reavaliada para as falhas presentes nas listas
+// das suas entradas (mais as falhas da propria porta), e as falhas cujo efeito desaparece
+// deixam de ser propagadas.
+//
+// As listas ficam em um unico vetor (pool) reaproveitado de um vetor de entradas para o
+// seguinte, ordenadas pelo indice da falha.
+//
+// As falhas, a deteccao e o relatorio sao os mesmos de SimuladorFalhas. Em circuitos com
+// lacos de realimentacao, a ordem de avaliacao nao eh topologica e a propagacao em uma
+// unica passada nao eh possivel; nesse caso eh usada a simulacao bit-paralela da classe base.
+class SimuladorConcorrente: public SimuladorFalhas {
+private:
+  // Um elemento da lista de divergencias de um sinal
+  struct Divergencia {
+    unsigned falha;
+    bool3S valor;
+  };
+
+  std::vector<Divergencia> pool;
+  // Lista do sinal S: pool[inicioLista[S]] ateh pool[fimLista[S]-1]
+  // (as listas sao gravadas na ordem de avaliacao: entradas e depois portas)
+  std::vector<unsigned> inicioLista;
+  std::vector<unsigned> fimLista;
+  // Valores do circuito sem falha
+  std::vector<bool3S> bom;
+
+public:
+  SimuladorConcorrente();
+
+  bool inicializar(const Circuit& C);
+
+  using SimuladorFalhas::simular;
+  // Simula um vetor de entradas para todas as falhas ainda nao detectadas
+  // Retorna o numero de falhas detectadas pela primeira vez por esse vetor
+  unsigned simular(const std::vector<bool3S>& in_circ);
+
+  // Numero medio de divergencias por sinal no ultimo vetor simulado
+  double divergenciasPorSinal() const;
+};
+
+#endif // _SIMCONCORRENTE_H_
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include "simfalhas.h"
+#include "rastro.h"
+
+///
+/// CLASSE SimuladorFalhas
+///
+
+SimuladorFalhas::SimuladorFalhas(): numDetectadas(0), numVetores(0) {}
+
+SimuladorFalhas::~SimuladorFalhas() {}
+
+// Compila o circuito e monta a lista completa de falhas
+bool SimuladorFalhas::inicializar(const Circuit& C)
+{
+  falhas.clear();
+  detectadaPor.clear();
+  numDetectadas = 0;
+  numVetores = 0;
+  if (!N.compilar(C)) return false;
+
+  for (unsigned s=0; s<N.getNumSinais(); s++)
+  {
+    falhas.push_back({N.idSinal(s), bool3S::FALSE});
+    falhas.push_back({N.idSinal(s), bool3S::TRUE});
+  }
+  detectadaPor.assign(falhas.size(), 0);
+  sinais.resize(N.getNumSinais());
+  forca.assign(N.getNumSinais(), bool3S_64{0,0});
+  return true;
+}
+
+// Marca todas as falhas como nao detectadas
+void SimuladorFalhas::zerar()
+{
+  detectadaPor.assign(falhas.size(), 0);
+  numDetectadas = 0;
+  numVetores = 0;
+}
+
+// Cobertura de falhas (de 0 a 1)
+double SimuladorFalhas::cobertura() const
+{
+  if (falhas.empty()) return 0.0;
+  return double(numDetectadas)/falhas.size();
+}
+
+// Simula um vetor de entradas para todas as falhas ainda nao detectadas
+unsigned SimuladorFalhas::simular(const std::vector<bool3S>& in_circ)
+{
+  if (in_circ.size()!=N.getNumInputs() || falhas.empty()) return 0;
+  numVetores++;
+
+  // Falhas ainda nao detectadas
+  std::vector<unsigned> resta;
+  for (unsigned i=0; i<falhas.size(); i++) if (detectadaPor[i]==0) resta.push_back(i);
+
+  unsigned novas = 0;
+  for (unsigned g=0; g<resta.size(); g+=63)
+  {
+    unsigned tam = std::min<unsigned>(63, resta.size()-g);
+
+    // Injeta as falhas do grupo nas pistas 1 a tam
+    for (unsigned k=0; k<tam; k++)
+    {
+      const Falha& F = falhas[resta[g+k]];
+      uint64_t m = uint64_t(1) << (k+1);
+      bool3S_64& fs = forca[N.sinal(F.id)];
+      if (F.valor==bool3S::TRUE) fs.t |= m;
+      else fs.f |= m;
+    }
+
+    for (unsigned i=0; i<N.getNumInputs(); i++) sinais[i] = difundir(in_circ[i]);
+    // O estado dos flip-flops eh desconhecido (simulacao combinacional)
+    for (unsigned p : N.getFlipFlops()) sinais[N.getNumInputs()+p] = bool3S_64{0,0};
+    N.simular(sinais.data(), forca.data());
+
+    // Pistas em que alguma saida definida difere da pista 0 (circuito sem falha)
+    uint64_t det = 0;
+    for (unsigned j=0; j<N.getNumOutputs(); j++)
+    {
+      const bool3S_64& v = sinais[N.getSaida(j)];
+      if (v.t & 1) det |= v.f;
+      else if (v.f & 1) det |= v.t;
+    }
+    det &= ~uint64_t(1);
+
+    for (unsigned k=0; k<tam; k++)
+    {
+      const Falha& F = falhas[resta[g+k]];
+      forca[N.sinal(F.id)] = bool3S_64{0,0};
+      if ((det >> (k+1)) & 1)
+      {
+        detectadaPor[resta[g+k]] = numVetores;
+        novas++;
+      }
+    }
+  }
+  numDetectadas += novas;
+  return novas;
+}
+
+// Simula um conjunto de vetores; retorna o numero de falhas detectadas pela primeira vez
+unsigned SimuladorFalhas::simular(const std::vector<std::vector<bool3S>>& Vetores)
+{
+  RASTRO_ESCOPO("simular falhas");
+  unsigned novas = 0;
+  for (unsigned v=0; v<Vetores.size() && numDetectadas<falhas.size(); v++) novas += simular(Vetores[v]);
+  return novas;
+}
+
+// Imprime a cobertura e, se ListarNaoDetectadas, as falhas nao detectadas
+std::ostream& SimuladorFalhas::imprimirRelatorio(std::ostream& O, bool ListarNaoDetectadas) const
+{
+  O << "Vetores: " << numVetores << '\n';
+  O << "Falhas: " << falhas.size() << ", detectadas: " << numDetectadas
+    << ", cobertura: " << 100.0*cobertura() << "%\n";
+  if (ListarNaoDetectadas)
+  {
+    O << "Falhas nao detectadas:";
+    for (unsigned i=0; i<falhas.size(); i++) if (detectadaPor[i]==0) O << ' ' << falhas[i];
+    O << '\n';
+  }
+  return O;
+}
+
+// Imprime uma falha no formato "id/sa0" ou "id/sa1"
+std::ostream& operator<<(std::ostream& O, const Falha& F)
+{
+  return O << F.id << (F.valor==bool3S::TRUE ? "/sa1" : "/sa0");
+}
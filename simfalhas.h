@@ -0,0 +1,98 @@
+#ifndef _SIMFALHAS_H_
+#define _SIMFALHAS_H_
+
+#include <iostream>
+#include <vector>
+#include "bool3S.h"
+#include "circuit.h"
+#include "netlist.h"
+
+///
+/// SIMULACAO DE FALHAS STUCK-AT
+///
+
+// Uma falha stuck-at: o sinal de id IdOrig (entrada do circuito se <0, saida de porta se >0)
+// fica preso no valor "valor" (FALSE: stuck-at-0; TRUE: stuck-at-1), qualquer que seja a
+// logica que o alimenta.
+struct Falha {
+  int id;
+  bool3S valor;
+};
+
+// Uma falha eh detectada por um vetor de entradas se alguma saida do circuito tem valor
+// definido (F ou T) no circuito sem falha e o valor oposto (tambem definido) no circuito
+// com a falha. Saidas UNDEF em qualquer dos dois circuitos nao detectam a falha.
+
+// Simulador bit-paralelo de falhas: em cada palavra bool3S_64, a pista 0 eh o circuito
+// sem falha e as pistas 1 a 63 sao 63 circuitos com uma falha cada. As falhas detectadas
+// sao descartadas (nao sao mais simuladas) nos vetores seguintes.
+class SimuladorFalhas {
+protected:
+  Netlist N;
+  // Lista de falhas (duas por sinal: stuck-at-0 e stuck-at-1)
+  std::vector<Falha> falhas;
+  // Para cada falha, o numero do vetor (a partir de 1) que a detectou pela primeira vez,
+  // ou 0 se ainda nao detectada
+  std::vector<unsigned long long> detectadaPor;
+  unsigned numDetectadas;
+  // Numero de vetores simulados desde a ultima chamada a zerar
+  unsigned long long numVetores;
+
+  // Areas de trabalho (sinais e forcamentos de um grupo de 63 falhas)
+  std::vector<bool3S_64> sinais;
+  std::vector<bool3S_64> forca;
+
+public:
+  /// ***********************
+  /// Inicializacao
+  /// ***********************
+
+  SimuladorFalhas();
+  virtual ~SimuladorFalhas();
+
+  // Compila o circuito e monta a lista completa de falhas (stuck-at-0 e stuck-at-1 em
+  // todas as entradas do circuito e saidas de portas)
+  // Retorna false se o circuito nao for valido
+  virtual bool inicializar(const Circuit& C);
+
+  // Marca todas as falhas como nao detectadas (para avaliar um novo conjunto de vetores)
+  void zerar();
+
+  /// ***********************
+  /// Funcoes de consulta
+  /// ***********************
+
+  unsigned getNumFalhas() const {return falhas.size();}
+  unsigned getNumDetectadas() const {return numDetectadas;}
+  unsigned long long getNumVetores() const {return numVetores;}
+  const Falha& getFalha(unsigned I) const {return falhas[I];}
+  bool detectada(unsigned I) const {return detectadaPor[I]!=0;}
+  unsigned long long getDetectadaPor(unsigned I) const {return detectadaPor[I];}
+
+  // Cobertura de falhas (de 0 a 1)
+  double cobertura() const;
+
+  /// ***********************
+  /// SIMULACAO
+  /// ***********************
+
+  // Simula um vetor de entradas para todas as falhas ainda nao detectadas
+  // Retorna o numero de falhas detectadas pela primeira vez por esse vetor
+  // (ou 0 se a dimensao da entrada for invalida)
+  virtual unsigned simular(const std::vector<bool3S>& in_circ);
+
+  // Simula um conjunto de vetores; retorna o numero de falhas detectadas pela primeira vez
+  unsigned simular(const std::vector<std::vector<bool3S>>& Vetores);
+
+  /// ***********************
+  /// E/S de dados
+  /// ***********************
+
+  // Imprime a cobertura e, se ListarNaoDetectadas, as falhas nao detectadas
+  std::ostream& imprimirRelatorio(std::ostream& O=std::cout, bool ListarNaoDetectadas=false) const;
+};
+
+// Imprime uma falha no formato "id/sa0" ou "id/sa1"
+std::ostream& operator<<(std::ostream& O, const Falha& F);
+
+#endif // _SIMFALHAS_H_
@@ -0,0 +1,525 @@
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <sstream>
+#include <functional>
+#include "tabela.h"
+#include "netlist.h"
+#include "rastro.h"
+
+using namespace std;
+
+// Numero de linhas de gerarTabela simuladas antes de serem impressas (um escopo de rastro
+// por fase de cada bloco: um escopo por linha encheria o rastro e apagaria as fases externas)
+static const unsigned LINHAS_BLOCO_TABELA = 1024;
+
+void gerarTabela(Circuit& C, ostream& O)
+{
+  vector<bool3S> in_circ(C.getNumInputs());
+  // Entradas e saidas das linhas do bloco atual
+  vector<bool3S> blocoIn, blocoOut;
+  const unsigned Nin = C.getNumInputs();
+  const unsigned Nout = C.getNumOutputs();
+  int i;
+  RASTRO_ESCOPO("gerarTabela");
+
+  // Comeca com todas as entradas indefinidas
+  for (i=0; i<(int)C.getNumInputs(); i++)
+  {
+    in_circ.at(i) = bool3S::UNDEF;
+  }
+
+  O << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  bool fim = false;
+  do
+  {
+    // Simulacao de um bloco de linhas
+    unsigned linhas = 0;
+    blocoIn.clear();
+    blocoOut.clear();
+    {
+      RASTRO_ESCOPO("simular");
+      while (linhas<LINHAS_BLOCO_TABELA && !fim)
+      {
+        C.simular(in_circ);
+        blocoIn.insert(blocoIn.end(), in_circ.begin(), in_circ.end());
+        for (unsigned j=1; j<=Nout; j++) blocoOut.push_back(C.getOutput(j));
+        linhas++;
+
+        // Determina qual entrada deve ser incrementada na proxima linha
+        // Incrementa a ultima possivel que nao for TRUE
+        // Se a ultima for TRUE, faz essa ser UNDEF e tenta incrementar a anterior
+        i = int(Nin)-1;
+        while (i>=0 && in_circ.at(i)==bool3S::TRUE)
+        {
+          in_circ.at(i)++;
+          i--;
+        };
+        // Incrementa a input selecionada
+        if (i>=0) in_circ.at(i)++;
+        else fim = true;
+      }
+    }
+
+    // Impressao do bloco
+    RASTRO_ESCOPO("imprimir linhas");
+    for (unsigned l=0; l<linhas; l++)
+    {
+      // Impressao das entradas
+      for (i=0; i<(int)Nin; i++)
+      {
+        O << blocoIn[size_t(l)*Nin+i];
+        if (i<(int)Nin-1) O << ' ';
+        else
+        {
+          O <<'\t';
+          if (Nin<=2) O <<'\t';
+        }
+      }
+
+      // Impressao das saidas
+      for (i=0; i<(int)Nout; i++)
+      {
+        O << blocoOut[size_t(l)*Nout+i];
+        if (i<(int)Nout-1) O << ' ';
+        else O << '\n';
+      }
+    }
+  } while (!fim);
+}
+
+
+
+///
+/// Tabela verdade com 2 valores
+///
+
+// Acrescenta a Buf as linhas (no formato de gerarTabela) das Pistas primeiras pistas das
+// entradas In e das saidas Out
+static void formatarLinhas(string& Buf, const bool3S_64* In, unsigned Nin,
+                           const bool3S_64* Out, unsigned Nout, unsigned Pistas)
+{
+  const char simbolo[3] = {'?', 'F', 'T'};
+  for (unsigned l=0; l<Pistas; l++)
+  {
+    for (unsigned i=0; i<Nin; i++)
+    {
+      Buf += simbolo[int(lerPista(In[i], l))];
+      if (i+1<Nin) Buf += ' ';
+      else
+      {
+        Buf += '\t';
+        if (Nin<=2) Buf += '\t';
+      }
+    }
+    for (unsigned j=0; j<Nout; j++)
+    {
+      Buf += simbolo[int(lerPista(Out[j], l))];
+      Buf += (j+1<Nout) ? ' ' : '\n';
+    }
+  }
+}
+
+bool gerarTabelaBinaria(const Circuit& C, ostream& O)
+{
+  RASTRO_ESCOPO("gerarTabelaBinaria");
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    cerr << "Circuito invalido para a tabela verdade\n";
+    return false;
+  }
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  if (Nin > MAX_ENTRADAS_BINARIA)
+  {
+    cerr << "Circuito com mais de " << MAX_ENTRADAS_BINARIA << " entradas para a tabela verdade\n";
+    return false;
+  }
+  const bool binaria = N.binaria();
+  const unsigned long long linhas = 1ULL << Nin;
+  // Valores (1: T) das 6 ultimas entradas nas 64 pistas: a pista l eh a linha r0+l
+  const uint64_t padrao[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+                              0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+  vector<uint64_t> S2(binaria ? N.getNumSinais() : 0, 0);
+  vector<bool3S_64> S3(N.getNumSinais(), bool3S_64{0,0});
+  vector<uint64_t> in(Nin);
+  vector<bool3S_64> in3(Nin), out(Nout);
+  string buf;
+
+  O << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  for (unsigned long long r0=0; r0<linhas; r0+=64)
+  {
+    unsigned pistas = unsigned(min<unsigned long long>(64, linhas-r0));
+    // O bit b do numero da linha eh o valor da entrada Nin-1-b
+    for (unsigned i=0; i<Nin; i++)
+    {
+      unsigned b = Nin-1-i;
+      in[i] = (b<6) ? padrao[b] : (((r0 >> b) & 1) ? ~uint64_t(0) : 0);
+    }
+    if (binaria)
+    {
+      for (unsigned i=0; i<Nin; i++) S2[i] = in[i];
+      N.simularBinario(S2.data());
+      for (unsigned j=0; j<Nout; j++) out[j] = bool3S_64{S2[N.getSaida(j)], ~S2[N.getSaida(j)]};
+    }
+    else
+    {
+      for (unsigned i=0; i<Nin; i++) S3[i] = bool3S_64{in[i], ~in[i]};
+      N.simular(S3.data());
+      for (unsigned j=0; j<Nout; j++) out[j] = S3[N.getSaida(j)];
+    }
+
+    for (unsigned i=0; i<Nin; i++) in3[i] = bool3S_64{in[i], ~in[i]};
+    buf.clear();
+    formatarLinhas(buf, in3.data(), Nin, out.data(), Nout, pistas);
+    O.write(buf.data(), buf.size());
+  }
+  return true;
+}
+
+
+///
+/// Tabela verdade restrita
+///
+
+// Leh os dominios das entradas de um texto com restricoes "id=valores"
+bool lerDominios(const string& Texto, unsigned Nin, vector<DominioEntrada>& D)
+{
+  string t = Texto;
+  replace(t.begin(), t.end(), ',', ' ');
+  istringstream I(t);
+  string restr;
+  D.assign(Nin, DOMINIO_TODOS);
+  while (I >> restr)
+  {
+    size_t igual = restr.find('=');
+    int id = 0;
+    istringstream L(restr.substr(0, igual));
+    if (igual==string::npos || !(L >> id) || !(L >> ws).eof() || id>=0 || unsigned(-id)>Nin)
+    {
+      cerr << "Restricao invalida: " << restr << "\n";
+      return false;
+    }
+    DominioEntrada d = 0;
+    for (char c : restr.substr(igual+1))
+    {
+      char u = toupper(c);
+      if (u!='F' && u!='T' && u!='?')
+      {
+        cerr << "Valor invalido na restricao: " << restr << "\n";
+        return false;
+      }
+      d |= DominioEntrada(1 << int(toBool3S(u)));
+    }
+    if (d==0)
+    {
+      cerr << "Restricao sem valores: " << restr << "\n";
+      return false;
+    }
+    D[-id-1] = d;
+  }
+  return true;
+}
+
+bool gerarTabelaRestrita(const Circuit& C, const vector<DominioEntrada>& D, ostream& O, unsigned NumThreads)
+{
+  RASTRO_ESCOPO("gerarTabelaRestrita");
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    cerr << "Circuito invalido para a tabela verdade\n";
+    return false;
+  }
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  if (D.size()!=Nin)
+  {
+    cerr << "Numero de dominios diferente do numero de entradas\n";
+    return false;
+  }
+
+  // Valores de cada entrada, na ordem de gerarTabela (?, F, T), e numero de linhas
+  vector<vector<bool3S>> valores(Nin);
+  unsigned long long linhas = 1;
+  bool indefinido = false;
+  for (unsigned i=0; i<Nin; i++)
+  {
+    for (int v=0; v<3; v++) if (D[i] & (1 << v)) valores[i].push_back(bool3S(v));
+    if (valores[i].empty() || linhas > (1ULL << 63)/valores[i].size())
+    {
+      cerr << "Dominios invalidos para a tabela verdade\n";
+      return false;
+    }
+    linhas *= valores[i].size();
+    if (D[i] & (1 << int(bool3S::UNDEF))) indefinido = true;
+  }
+  const bool binaria = !indefinido && N.binaria();
+
+  // Simula e formata as linhas K0 a K1-1 em Buf
+  auto simularBloco = [&](unsigned long long K0, unsigned long long K1, string& Buf)
+  {
+    vector<uint64_t> S2(binaria ? N.getNumSinais() : 0, 0);
+    vector<bool3S_64> S3(N.getNumSinais(), bool3S_64{0,0});
+    vector<bool3S_64> in(Nin), out(Nout);
+    vector<unsigned> dig(Nin);
+    // Digitos de K0, com a ultima entrada variando mais rapido
+    unsigned long long k = K0;
+    for (unsigned i=Nin; i-- > 0; ) {dig[i] = k % valores[i].size(); k /= valores[i].size();}
+    Buf.clear();
+    for (unsigned long long r0=K0; r0<K1; r0+=64)
+    {
+      unsigned pistas = unsigned(min<unsigned long long>(64, K1-r0));
+      for (unsigned i=0; i<Nin; i++) in[i] = bool3S_64{0,0};
+      for (unsigned l=0; l<pistas; l++)
+      {
+        for (unsigned i=0; i<Nin; i++) fixarPista(in[i], l, valores[i][dig[i]]);
+        for (unsigned i=Nin; i-- > 0 && ++dig[i]==valores[i].size(); ) dig[i] = 0;
+      }
+      if (binaria)
+      {
+        for (unsigned i=0; i<Nin; i++) S2[i] = in[i].t;
+        N.simularBinario(S2.data());
+        for (unsigned j=0; j<Nout; j++) out[j] = bool3S_64{S2[N.getSaida(j)], ~S2[N.getSaida(j)]};
+      }
+      else
+      {
+        for (unsigned i=0; i<Nin; i++) S3[i] = in[i];
+        N.simular(S3.data());
+        for (unsigned j=0; j<Nout; j++) out[j] = S3[N.getSaida(j)];
+      }
+      formatarLinhas(Buf, in.data(), Nin, out.data(), Nout, pistas);
+    }
+  };
+
+  O << "ENTRADAS" << '\t' << "SAIDAS" << endl;
+  const unsigned long long LINHAS_BLOCO = 64*256;
+  if (NumThreads==0) NumThreads = thread::hardware_concurrency();
+  if (NumThreads==0) NumThreads = 1;
+  if (linhas <= LINHAS_BLOCO) NumThreads = 1;
+
+  // Em cada rodada, a thread t formata o bloco b0+t; os blocos sao escritos em ordem
+  vector<string> buf(NumThreads);
+  for (unsigned long long k0=0; k0<linhas; k0+=NumThreads*LINHAS_BLOCO)
+  {
+    vector<thread> threads;
+    for (unsigned t=0; t<NumThreads; t++)
+    {
+      unsigned long long a = k0+t*LINHAS_BLOCO;
+      unsigned long long b = min(linhas, a+LINHAS_BLOCO);
+      if (a>=b) {buf[t].clear(); continue;}
+      if (t==0) continue;
+      threads.emplace_back(simularBloco, a, b, ref(buf[t]));
+    }
+    simularBloco(k0, min(linhas, k0+LINHAS_BLOCO), buf[0]);
+    for (thread& T : threads) T.join();
+    for (const string& B : buf) O.write(B.data(), B.size());
+  }
+  return true;
+}
+
+///
+/// Resumo da tabela verdade
+///
+
+// Retorna true se a saida J tem sempre o mesmo valor (em V)
+bool ResumoTabela::constante(unsigned J, bool3S& V) const
+{
+  for (int v=0; v<3; v++)
+  {
+    if (contagem[v][J]==numVetores)
+    {
+      V = bool3S(v);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Entradas que alcancam cada sinal pelas portas (uma mascara de bits por sinal)
+// Os flip-flops sao fontes de sinal (estado UNDEF): nao propagam o suporte da entrada D
+static std::vector<uint32_t> suporteEstrutural(const Netlist& N)
+{
+  const unsigned Nin = N.getNumInputs();
+  std::vector<uint32_t> sup(N.getNumSinais(), 0);
+  for (unsigned i=0; i<Nin; i++) sup[i] = uint32_t(1) << i;
+  // Com lacos, repete ateh nao mudar
+  bool mudou;
+  do
+  {
+    mudou = false;
+    for (unsigned P : N.getOrdem())
+    {
+      if (N.getTipo(P)==TipoPorta::FF) continue;
+      uint32_t m = 0;
+      const unsigned* e = N.getEntradas(P);
+      for (unsigned k=0; k<N.getNumInputsPort(P); k++) m |= sup[e[k]];
+      if (m != sup[Nin+P])
+      {
+        sup[Nin+P] = m;
+        mudou = true;
+      }
+    }
+  } while (mudou && N.realimentada());
+  return sup;
+}
+
+bool resumirTabela(const Circuit& C, ResumoTabela& R, unsigned NumThreads)
+{
+  RASTRO_ESCOPO("resumir tabela");
+  Netlist N;
+  if (!N.compilar(C))
+  {
+    cerr << "Circuito invalido para o resumo da tabela verdade\n";
+    return false;
+  }
+  const unsigned Nin = N.getNumInputs();
+  const unsigned Nout = N.getNumOutputs();
+  if (Nin > MAX_ENTRADAS_RESUMO)
+  {
+    cerr << "Circuito com mais de " << MAX_ENTRADAS_RESUMO << " entradas para o resumo da tabela verdade\n";
+    return false;
+  }
+  unsigned long long total = 1;
+  for (unsigned i=0; i<Nin; i++) total *= 3;
+  const unsigned long long numPalavras = (total+63)/64;
+
+  R.numEntradas = Nin;
+  R.numVetores = total;
+  for (int v=0; v<3; v++) R.contagem[v].assign(Nout, 0);
+  R.depende.assign(Nout, std::vector<bool>(Nin, false));
+
+  // Entradas que podem influir em cada saida
+  std::vector<uint32_t> sup = suporteEstrutural(N);
+  std::vector<uint32_t> cone(Nout);
+  for (unsigned j=0; j<Nout; j++) cone[j] = sup[N.getSaida(j)];
+
+  const unsigned long long PALAVRAS_BLOCO = 64;
+  std::atomic<unsigned long long> proximoBloco(0);
+  std::mutex mtx;
+
+  auto trabalhador = [&]()
+  {
+    // Acumuladores da thread
+    std::vector<unsigned long long> cont[2];
+    cont[0].assign(Nout, 0);
+    cont[1].assign(Nout, 0);
+    unsigned long long numPistas = 0;
+    // falta[j]: entradas do cone da saida j cuja dependencia ainda nao foi encontrada
+    std::vector<uint32_t> falta(cone), dep(Nout, 0);
+
+    std::vector<bool3S_64> S(N.getNumSinais(), bool3S_64{0,0});
+    std::vector<bool3S_64> in(Nin), base(Nout);
+    std::vector<unsigned char> dig(Nin);
+    while (true)
+    {
+      unsigned long long w0 = (proximoBloco++)*PALAVRAS_BLOCO;
+      if (w0>=numPalavras) break;
+      unsigned long long w1 = std::min(numPalavras, w0+PALAVRAS_BLOCO);
+      for (unsigned long long w=w0; w<w1; w++)
+      {
+        // Combinacoes 64*w a 64*w+63: o digito i (na base 3) do indice eh o valor de bool3S
+        // da entrada Nin-1-i, como na ordem de gerarTabela
+        unsigned long long k = w*64;
+        for (unsigned i=Nin; i-- > 0; ) {dig[i] = k%3; k /= 3;}
+        for (unsigned i=0; i<Nin; i++) in[i] = bool3S_64{0,0};
+        unsigned pistas = unsigned(std::min<unsigned long long>(64, total-w*64));
+        for (unsigned l=0; l<pistas; l++)
+        {
+          uint64_t bit = uint64_t(1) << l;
+          for (unsigned i=0; i<Nin; i++)
+          {
+            if (dig[i]==1) in[i].f |= bit;
+            else if (dig[i]==2) in[i].t |= bit;
+          }
+          for (unsigned i=Nin; i-- > 0 && ++dig[i]==3; ) dig[i] = 0;
+        }
+        uint64_t mascara = (pistas==64) ? ~uint64_t(0) : ((uint64_t(1) << pistas)-1);
+
+        // Contagens
+        for (unsigned i=0; i<Nin; i++) S[i] = in[i];
+        N.simular(S.data());
+        for (unsigned j=0; j<Nout; j++)
+        {
+          base[j] = S[N.getSaida(j)];
+          cont[0][j] += contarBits(base[j].f & mascara);
+          cont[1][j] += contarBits(base[j].t & mascara);
+        }
+        numPistas += pistas;
+
+        // Dependencias: troca o valor de uma entrada por vez (? -> F -> T -> ?)
+        uint32_t entradas = 0;
+        for (unsigned j=0; j<Nout; j++) entradas |= falta[j];
+        for (unsigned i=0; i<Nin && entradas!=0; i++)
+        {
+          uint32_t bitEntr = uint32_t(1) << i;
+          if ((entradas & bitEntr)==0) continue;
+          for (unsigned e=0; e<Nin; e++) S[e] = in[e];
+          S[i] = bool3S_64{in[i].f, ~(in[i].t | in[i].f)};
+          N.simular(S.data());
+          for (unsigned j=0; j<Nout; j++)
+          {
+            if ((falta[j] & bitEntr)==0) continue;
+            const bool3S_64& x = S[N.getSaida(j)];
+            if (((x.t ^ base[j].t) | (x.f ^ base[j].f)) & mascara)
+            {
+              falta[j] &= ~bitEntr;
+              dep[j] |= bitEntr;
+            }
+          }
+          entradas = 0;
+          for (unsigned j=0; j<Nout; j++) entradas |= falta[j];
+        }
+      }
+    }
+
+    // Soma os acumuladores da thread no resultado
+    std::lock_guard<std::mutex> L(mtx);
+    for (unsigned j=0; j<Nout; j++)
+    {
+      R.contagem[int(bool3S::FALSE)][j] += cont[0][j];
+      R.contagem[int(bool3S::TRUE)][j] += cont[1][j];
+      R.contagem[int(bool3S::UNDEF)][j] += numPistas-cont[0][j]-cont[1][j];
+      for (unsigned i=0; i<Nin; i++) if (dep[j] & (uint32_t(1) << i)) R.depende[j][i] = true;
+    }
+  };
+
+  if (NumThreads==0) NumThreads = std::thread::hardware_concurrency();
+  if (NumThreads==0) NumThreads = 1;
+  std::vector<std::thread> threads;
+  for (unsigned t=1; t<NumThreads; t++) threads.emplace_back(trabalhador);
+  trabalhador();
+  for (std::thread& T : threads) T.join();
+  return true;
+}
+
+// Imprime o resumo da tabela verdade
+ostream& operator<<(ostream& O, const ResumoTabela& R)
+{
+  const unsigned Nout = R.depende.size();
+  bool3S v;
+  O << "RESUMO DA TABELA VERDADE (" << R.numVetores << " combinacoes de " << R.numEntradas << " entradas)\n";
+  O << "SAIDA" << '\t' << "F" << '\t' << "T" << '\t' << "?" << '\t' << "DEPENDE DE" << '\n';
+  for (unsigned j=0; j<Nout; j++)
+  {
+    O << j+1 << '\t' << R.contagem[int(bool3S::FALSE)][j] << '\t' << R.contagem[int(bool3S::TRUE)][j]
+      << '\t' << R.contagem[int(bool3S::UNDEF)][j] << '\t';
+    unsigned n = 0;
+    for (unsigned i=0; i<R.numEntradas; i++)
+    {
+      if (R.depende[j][i]) O << (n++ > 0 ? " " : "") << -int(i)-1;
+    }
+    if (n==0) O << '-';
+    O << '\n';
+  }
+  O << "Saidas constantes:";
+  unsigned n = 0;
+  for (unsigned j=0; j<Nout; j++)
+  {
+    if (R.constante(j, v)) {O << ' ' << j+1 << '=' << v; n++;}
+  }
+  if (n==0) O << " nenhuma";
+  O << '\n';
+  return O;
+}
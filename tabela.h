@@ -0,0 +1,96 @@
+#ifndef _TABELA_H_
+#define _TABELA_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "circuit.h"
+
+///
+/// TABELA VERDADE
+///
+
+// Simula o circuito para todas as 3^Nin combinacoes de entradas (F, T e ?) e imprime
+// a tabela verdade na ostream O: uma linha de cabecalho e, para cada combinacao, os
+// valores das entradas, uma tabulacao e os valores das saidas.
+// A primeira linha tem todas as entradas indefinidas; a cada linha, a ultima entrada
+// eh incrementada (? -> F -> T -> ?), com "vai um" para a entrada anterior.
+void gerarTabela(Circuit& C, std::ostream& O=std::cout);
+
+// Tabela verdade apenas com entradas definidas (F e T): 2^Nin linhas, no mesmo formato e
+// na mesma ordem relativa de gerarTabela (a ultima entrada varia mais rapido, F antes de T).
+// As linhas sao simuladas 64 por vez; se a netlist for binaria (sem lacos e sem
+// flip-flops), com 2 valores (Netlist::simularBinario), senao com 3 valores, pois um laco
+// ou um flip-flop pode dar ? mesmo com as entradas definidas.
+// Retorna false (com uma mensagem em cerr) se o circuito for invalido ou se houver mais
+// de MAX_ENTRADAS_BINARIA entradas
+const unsigned MAX_ENTRADAS_BINARIA = 63;
+bool gerarTabelaBinaria(const Circuit& C, std::ostream& O=std::cout);
+
+///
+/// TABELA VERDADE RESTRITA
+///
+
+// Dominio de uma entrada: o conjunto dos valores que ela pode assumir na enumeracao,
+// um bit por valor (bit int(bool3S): 1 para ?, 2 para F, 4 para T)
+typedef unsigned char DominioEntrada;
+const DominioEntrada DOMINIO_TODOS = 7;
+
+// Leh os dominios das entradas de um texto com restricoes "id=valores" separadas por
+// virgulas ou espacos, por exemplo "-1=T, -3=T, -2=FT" (valores com os caracteres ?, F e T).
+// As entradas sem restricao ficam com todos os valores.
+// Retorna false (com uma mensagem em cerr) se o texto for invalido
+bool lerDominios(const std::string& Texto, unsigned Nin, std::vector<DominioEntrada>& D);
+
+// Tabela verdade apenas com as combinacoes em que cada entrada i tem um valor de D[i],
+// no mesmo formato e na mesma ordem relativa de gerarTabela.
+// As linhas sao simuladas 64 por vez (com 2 valores se nenhum dominio tiver ? e a netlist
+// for binaria). Quando ha muitas linhas, blocos de linhas consecutivas sao simulados e
+// formatados por NumThreads threads (0: uma por nucleo) e escritos na ordem.
+// Retorna false (com uma mensagem em cerr) se o circuito ou os dominios forem invalidos
+// (algum dominio vazio ou mais de 2^63 linhas)
+bool gerarTabelaRestrita(const Circuit& C, const std::vector<DominioEntrada>& D,
+                         std::ostream& O=std::cout, unsigned NumThreads=0);
+
+///
+/// RESUMO DA TABELA VERDADE
+///
+
+// Percorre as mesmas 3^Nin combinacoes de gerarTabela, sem montar nem imprimir as linhas,
+// e calcula apenas:
+// - quantas combinacoes dao a cada saida o valor F, T e ?;
+// - quais saidas sao constantes (o mesmo valor em todas as combinacoes);
+// - de quais entradas depende cada saida: a saida j depende da entrada i se ha duas
+//   combinacoes que diferem apenas na entrada i com valores diferentes na saida j.
+// As combinacoes sao simuladas 64 por vez (Netlist, bool3S_64) por NumThreads threads,
+// cada uma com os seus proprios contadores, somados no final. Para as dependencias, cada
+// palavra eh simulada de novo com o valor de uma entrada trocado (? -> F -> T -> ?), mas
+// apenas para as entradas que alcancam estruturalmente alguma saida cuja dependencia
+// ainda nao foi encontrada pela thread.
+// Os flip-flops, se houver, ficam com estado UNDEF.
+
+// Numero maximo de entradas para o resumo (3^20 combinacoes)
+const unsigned MAX_ENTRADAS_RESUMO = 20;
+
+struct ResumoTabela {
+  unsigned numEntradas;
+  unsigned long long numVetores;
+  // Numero de combinacoes em que a saida j vale F, T e ? (indice: valor de bool3S)
+  std::vector<unsigned long long> contagem[3];
+  // depende[j][i]: a saida j depende da entrada i
+  std::vector<std::vector<bool>> depende;
+
+  // Retorna true se a saida j (a partir de 0) tem sempre o mesmo valor (em V)
+  bool constante(unsigned J, bool3S& V) const;
+};
+
+// Calcula o resumo da tabela verdade do circuito C
+// Retorna false (com uma mensagem em cerr) se o circuito for invalido ou se houver mais
+// de MAX_ENTRADAS_RESUMO entradas
+bool resumirTabela(const Circuit& C, ResumoTabela& R, unsigned NumThreads=0);
+
+// Imprime o resumo: uma linha por saida (contagens e entradas das quais ela depende)
+// e a lista das saidas constantes
+std::ostream& operator<<(std::ostream& O, const ResumoTabela& R);
+
+#endif // _TABELA_H_